@@ -0,0 +1,175 @@
+#include "bench_harness.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace SudokuBench {
+
+namespace {
+
+    struct Registered {
+        std::string name;
+        BenchmarkFn fn;
+    };
+
+    std::vector<Registered>& registry() {
+        static std::vector<Registered> benchmarks;
+        return benchmarks;
+    }
+
+    struct Result {
+        std::string name;
+        uint64_t iterations = 0;
+        double realNs = 0.0;    ///< Per iteration.
+        double cpuNs = 0.0;
+        double itemsPerSecond = 0.0;
+        std::string label;
+        std::string error;
+    };
+
+    Result runOne(const Registered& bench, double minSeconds, int repetitions) {
+        Result best;
+        best.name = bench.name;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            uint64_t iterations = 1;
+            for (;;) {
+                State state(iterations);
+                bench.fn(state);
+                if (!state.error.empty()) {
+                    best.error = state.error;
+                    return best;
+                }
+                const double seconds = state.realSeconds();
+                if (seconds >= minSeconds || iterations >= 1000000000ull) {
+                    const double realNs = seconds * 1e9 / static_cast<double>(iterations);
+                    if (best.iterations == 0 || realNs < best.realNs) {
+                        best.iterations = iterations;
+                        best.realNs = realNs;
+                        best.cpuNs = state.cpuSeconds() * 1e9 / static_cast<double>(iterations);
+                        best.itemsPerSecond = state.itemsProcessed && seconds > 0 ? static_cast<double>(state.itemsProcessed) / seconds : 0.0;
+                        best.label = state.label;
+                    }
+                    break;
+                }
+                // Aim 40% past the target from the last measurement, growing at most 10x at a time.
+                const double scale = seconds > 0 ? std::min(10.0, std::max(1.5, minSeconds * 1.4 / seconds)) : 10.0;
+                iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale) + 1;
+            }
+        }
+        return best;
+    }
+
+    std::string formatTime(double ns) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(ns < 10 ? 2 : (ns < 1000 ? 1 : 0)) << ns << " ns";
+        return out.str();
+    }
+
+    std::string jsonEscape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') out.push_back('\\');
+            out.push_back(c);
+        }
+        return out;
+    }
+
+    void writeJson(const std::string& path, const std::vector<Result>& results, const char* executable) {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << path << std::endl;
+            return;
+        }
+        char date[64];
+        const std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        out << std::setprecision(10);
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"executable\": \"" << jsonEscape(executable) << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+            << "    \"library_build_type\": \"release\"\n"
+#else
+            << "    \"library_build_type\": \"debug\"\n"
+#endif
+            << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i ? ",\n" : "\n") << "    {\n"
+                << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+                << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n"
+                << "      \"run_type\": \"iteration\",\n";
+            if (!r.error.empty()) {
+                out << "      \"error_occurred\": true,\n"
+                    << "      \"error_message\": \"" << jsonEscape(r.error) << "\"\n    }";
+                continue;
+            }
+            out << "      \"iterations\": " << r.iterations << ",\n"
+                << "      \"real_time\": " << r.realNs << ",\n"
+                << "      \"cpu_time\": " << r.cpuNs << ",\n"
+                << "      \"time_unit\": \"ns\"";
+            if (r.itemsPerSecond > 0) out << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+            if (!r.label.empty()) out << ",\n      \"label\": \"" << jsonEscape(r.label) << "\"";
+            out << "\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+}
+
+void registerBenchmark(const std::string& name, BenchmarkFn fn) {
+    registry().push_back({name, std::move(fn)});
+}
+
+
+int runBenchmarks(int argc, char* argv[]) {
+    std::string filter;
+    std::string jsonPath;
+    double minSeconds = 0.5;
+    int repetitions = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        try {
+            if (arg.rfind("--filter=", 0) == 0) filter = arg.substr(9);
+            else if (arg.rfind("--json=", 0) == 0) jsonPath = arg.substr(7);
+            else if (arg.rfind("--min-time=", 0) == 0) minSeconds = std::stod(arg.substr(11));
+            else if (arg.rfind("--repetitions=", 0) == 0) repetitions = std::max(1, std::stoi(arg.substr(14)));
+        } catch (...) {
+            std::cerr << "Error: Invalid value in '" << arg << "'." << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    size_t width = 10;
+    for (const Registered& bench : registry()) width = std::max(width, bench.name.size());
+    std::printf("%-*s %15s %15s %12s %16s\n", static_cast<int>(width), "Benchmark", "Time", "CPU", "Iterations", "Items/s");
+    std::printf("%s\n", std::string(width + 63, '-').c_str());
+    for (const Registered& bench : registry()) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) continue;
+        const Result r = runOne(bench, minSeconds, repetitions);
+        if (!r.error.empty()) {
+            std::printf("%-*s ERROR: %s\n", static_cast<int>(width), r.name.c_str(), r.error.c_str());
+        } else {
+            char items[32] = "";
+            if (r.itemsPerSecond > 0) std::snprintf(items, sizeof(items), "%.4g", r.itemsPerSecond);
+            std::printf("%-*s %15s %15s %12llu %16s %s\n", static_cast<int>(width), r.name.c_str(), formatTime(r.realNs).c_str(),
+                        formatTime(r.cpuNs).c_str(), static_cast<unsigned long long>(r.iterations), items, r.label.c_str());
+        }
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+    if (!jsonPath.empty()) writeJson(jsonPath, results, argv[0]);
+    for (const Result& r : results) if (!r.error.empty()) return 1;
+    return 0;
+}
+
+}
@@ -0,0 +1,91 @@
+#ifndef SUDOKU_BENCH_HARNESS_HPP
+#define SUDOKU_BENCH_HARNESS_HPP
+
+// A small self-contained benchmark harness modelled on Google Benchmark: benchmarks are
+// functions taking a State and looping `for (auto _ : state)`, iteration counts are scaled
+// until a run takes at least --min-time, and --json writes results in Google Benchmark's
+// JSON schema so its compare.py and CI dashboards can read them. No external dependency.
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+
+namespace SudokuBench {
+
+    class State {
+    public:
+        explicit State(uint64_t iterations) : maxIterations(iterations) {}
+
+        struct Iterator {
+            State* state;
+            uint64_t remaining;
+
+            bool operator!=(const Iterator&) {
+                if (remaining != 0) return true;
+                state->stopTimer();
+                return false;
+            }
+            void operator++() { --remaining; }
+            int operator*() const { return 0; }
+        };
+
+        Iterator begin() { startTimer(); return Iterator{this, maxIterations}; }
+        Iterator end() { return Iterator{this, 0}; }
+
+        uint64_t iterations() const { return maxIterations; }
+
+        /** @brief Work items per iteration total (e.g. puzzles); reported as items_per_second. */
+        void setItemsProcessed(uint64_t items) { itemsProcessed = items; }
+
+        /** @brief Free-form text shown next to the result (e.g. the kernel in use). */
+        void setLabel(const std::string& text) { label = text; }
+
+        /** @brief Marks the run as failed; it is reported with the message and no timings. */
+        void skipWithError(const std::string& message) { error = message; }
+
+        double realSeconds() const { return std::chrono::duration<double>(realStop - realStart).count(); }
+        double cpuSeconds() const { return static_cast<double>(cpuStop - cpuStart) / CLOCKS_PER_SEC; }
+
+        uint64_t itemsProcessed = 0;
+        std::string label;
+        std::string error;
+
+    private:
+        void startTimer() { realStart = std::chrono::steady_clock::now(); cpuStart = std::clock(); }
+        void stopTimer() { realStop = std::chrono::steady_clock::now(); cpuStop = std::clock(); }
+
+        uint64_t maxIterations;
+        std::chrono::steady_clock::time_point realStart, realStop;
+        std::clock_t cpuStart = 0, cpuStop = 0;
+    };
+
+    using BenchmarkFn = std::function<void(State&)>;
+
+    /** @brief Adds a benchmark; the name may contain '/' to group variants. */
+    void registerBenchmark(const std::string& name, BenchmarkFn fn);
+
+    /**
+     * @brief Runs the registered benchmarks and prints a table.
+     *
+     * Options: --filter=<substring>, --min-time=<seconds> (default 0.5),
+     * --json=<path> (Google Benchmark JSON), --repetitions=<n> (best run is reported).
+     * @return Process exit code.
+     */
+    int runBenchmarks(int argc, char* argv[]);
+
+    /** @brief Keeps the compiler from optimizing away a computed value. */
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+#include "corpus.hpp"
+
+#include "sudoku_solver.hpp"
+
+#include <random>
+#include <utility>
+
+namespace SudokuBench {
+
+namespace {
+
+    const char* const SEVENTEEN_CLUE_SEEDS[] = {
+        "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+        "000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+    };
+
+    constexpr int EASY_CLUES = 36;
+
+    class Generator {
+    public:
+        explicit Generator(uint64_t seed) : rng(seed) {}
+
+        /** @brief Uniform-enough value in [0, bound); the modulo bias is irrelevant here. */
+        unsigned below(unsigned bound) { return static_cast<unsigned>(rng() % bound); }
+
+        template <typename T>
+        void shuffle(T* first, int n) {
+            for (int i = n - 1; i > 0; --i) std::swap(first[i], first[below(static_cast<unsigned>(i + 1))]);
+        }
+
+        /** @brief A random solved grid: the three diagonal boxes are independent, the solver fills the rest. */
+        std::string solvedGrid() {
+            std::string grid(81, '0');
+            for (int box = 0; box < 3; ++box) {
+                char digits[9] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+                shuffle(digits, 9);
+                for (int k = 0; k < 9; ++k) grid[(box * 3 + k / 3) * 9 + box * 3 + k % 3] = digits[k];
+            }
+            solver.initialize(grid.data(), 81);
+            solver.solve();
+            // Relabel and transform so the solver's fill order does not show in the result.
+            return transform(std::string(solver.getSolution(), 81));
+        }
+
+        /** @brief Removes clues in random order while the solution stays unique, down to `minClues`. */
+        std::string dig(std::string puzzle, int minClues) {
+            int order[81];
+            for (int i = 0; i < 81; ++i) order[i] = i;
+            shuffle(order, 81);
+            int clues = 81;
+            for (int i = 0; i < 81 && clues > minClues; ++i) {
+                const char saved = puzzle[order[i]];
+                puzzle[order[i]] = '0';
+                solver.initialize(puzzle.data(), 81);
+                if (solver.countSolutions(2) == 1) clues--;
+                else puzzle[order[i]] = saved;
+            }
+            return puzzle;
+        }
+
+        std::string easy() { return dig(solvedGrid(), EASY_CLUES); }
+
+        std::string hard() { return dig(solvedGrid(), 0); }
+
+        std::string seventeen() { return transform(SEVENTEEN_CLUE_SEEDS[below(2)]); }
+
+        // Validity-preserving transform: digit relabeling, row/column permutations within bands
+        // and stacks, band/stack permutations and an optional transpose.
+        std::string transform(const std::string& puzzle) {
+            char digits[10] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+            shuffle(digits + 1, 9);
+            int rows[9], cols[9];
+            lineOrder(rows);
+            lineOrder(cols);
+            const bool transpose = (rng() & 1) != 0;
+            std::string out(81, '0');
+            for (int r = 0; r < 9; ++r) {
+                for (int c = 0; c < 9; ++c) {
+                    const char ch = puzzle[rows[r] * 9 + cols[c]];
+                    out[transpose ? c * 9 + r : r * 9 + c] = (ch >= '1' && ch <= '9') ? digits[ch - '0'] : '0';
+                }
+            }
+            return out;
+        }
+
+        std::string invalid() {
+            std::string puzzle = easy();
+            switch (below(4)) {
+            case 0: {
+                // Two equal givens in one row.
+                const int row = static_cast<int>(below(9));
+                int filled = -1, empty = -1;
+                for (int c = 0; c < 9; ++c) {
+                    const int cell = row * 9 + c;
+                    if (puzzle[cell] != '0' && filled < 0) filled = cell;
+                    if (puzzle[cell] == '0' && empty < 0) empty = cell;
+                }
+                if (filled >= 0 && empty >= 0) puzzle[empty] = puzzle[filled];
+                else puzzle[0] = puzzle[1] = '5';
+                return puzzle;
+            }
+            case 1: return puzzle.substr(0, 80);
+            case 2: return puzzle + puzzle[0];
+            default: return std::string();
+            }
+        }
+
+        /** @brief `puzzle` with blanks or tabs between some cells, trailing blanks and maybe a CR. */
+        std::string decorate(const std::string& puzzle) {
+            static const char BLANKS[] = {' ', '\t'};
+            std::string out;
+            for (size_t i = 0; i < puzzle.size(); ++i) {
+                out.push_back(puzzle[i]);
+                if (i % 9 == 8 && below(3) == 0) out.push_back(BLANKS[below(2)]);
+            }
+            for (unsigned n = below(3); n > 0; --n) out.push_back(BLANKS[below(2)]);
+            if (below(2) == 0) out.push_back('\r');
+            return out;
+        }
+
+        std::string record(CorpusKind kind) {
+            switch (kind) {
+            case CorpusKind::Easy: return easy();
+            case CorpusKind::Hard: return hard();
+            case CorpusKind::Seventeen: return seventeen();
+            case CorpusKind::Invalid: return invalid();
+            case CorpusKind::Whitespace: return decorate(easy());
+            case CorpusKind::Mixed: break;
+            }
+            static const CorpusKind MIX[] = {CorpusKind::Easy, CorpusKind::Easy, CorpusKind::Hard, CorpusKind::Seventeen,
+                                             CorpusKind::Invalid, CorpusKind::Whitespace};
+            return record(MIX[below(6)]);
+        }
+
+    private:
+        void lineOrder(int result[9]) {
+            int outer[3] = {0, 1, 2};
+            shuffle(outer, 3);
+            for (int b = 0; b < 3; ++b) {
+                int inner[3] = {0, 1, 2};
+                shuffle(inner, 3);
+                for (int k = 0; k < 3; ++k) result[b * 3 + k] = outer[b] * 3 + inner[k];
+            }
+        }
+
+        std::mt19937_64 rng;
+        SudokuApp::SudokuSolver solver;
+    };
+
+}
+
+bool parseCorpusKind(const std::string& text, CorpusKind& kind) {
+    static const std::pair<const char*, CorpusKind> NAMES[] = {
+        {"easy", CorpusKind::Easy}, {"hard", CorpusKind::Hard}, {"17", CorpusKind::Seventeen},
+        {"invalid", CorpusKind::Invalid}, {"whitespace", CorpusKind::Whitespace}, {"mixed", CorpusKind::Mixed},
+    };
+    for (const auto& entry : NAMES) {
+        if (text == entry.first) {
+            kind = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* corpusKindName(CorpusKind kind) {
+    switch (kind) {
+    case CorpusKind::Easy: return "easy";
+    case CorpusKind::Hard: return "hard";
+    case CorpusKind::Seventeen: return "17";
+    case CorpusKind::Invalid: return "invalid";
+    case CorpusKind::Whitespace: return "whitespace";
+    case CorpusKind::Mixed: return "mixed";
+    }
+    return "?";
+}
+
+std::string generateCorpus(CorpusKind kind, size_t count, uint64_t seed) {
+    Generator generator(seed);
+    std::string text;
+    for (size_t i = 0; i < count; ++i) {
+        text += generator.record(kind);
+        text.push_back('\n');
+    }
+    return text;
+}
+
+}
@@ -0,0 +1,36 @@
+#ifndef SUDOKU_BENCH_CORPUS_HPP
+#define SUDOKU_BENCH_CORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SudokuBench {
+
+    enum class CorpusKind {
+        Easy,        ///< Unique-solution puzzles dug down to about 36 clues.
+        Hard,        ///< Minimal unique-solution puzzles (no clue can be removed), ~22-26 clues.
+        Seventeen,   ///< Transforms of known 17-clue puzzles.
+        Invalid,     ///< Conflicting givens and records of the wrong length.
+        Whitespace,  ///< Easy puzzles with CRLF, blanks and tabs that the reader has to strip.
+        Mixed        ///< All of the above interleaved.
+    };
+
+    /** @brief Parses "easy", "hard", "17", "invalid", "whitespace" or "mixed". */
+    bool parseCorpusKind(const std::string& text, CorpusKind& kind);
+
+    const char* corpusKindName(CorpusKind kind);
+
+    /**
+     * @brief Generates `count` newline-terminated records of the given kind.
+     *
+     * The output depends only on (kind, count, seed): the generator uses mt19937_64, whose
+     * sequence is fixed by the standard, and no std distributions or std::shuffle, whose
+     * results differ between standard libraries. A corpus can therefore be regenerated
+     * anywhere instead of being stored.
+     */
+    std::string generateCorpus(CorpusKind kind, size_t count, uint64_t seed);
+
+}
+
+#endif
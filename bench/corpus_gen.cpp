@@ -0,0 +1,41 @@
+// Writes a reproducible synthetic corpus for benchmarks and CI artifacts.
+//
+// Usage: corpus_gen <easy|hard|17|invalid|whitespace|mixed> <count> <seed> [output.txt]
+// Writes to stdout without an output file. The same arguments give the same bytes on
+// every platform.
+
+#include "corpus.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    SudokuBench::CorpusKind kind;
+    if (argc < 4 || !SudokuBench::parseCorpusKind(argv[1], kind)) {
+        std::cerr << "Usage: " << argv[0] << " <easy|hard|17|invalid|whitespace|mixed> <count> <seed> [output.txt]" << std::endl;
+        return 1;
+    }
+    size_t count = 0;
+    unsigned long long seed = 0;
+    try {
+        count = std::stoull(argv[2]);
+        seed = std::stoull(argv[3]);
+    } catch (...) {
+        std::cerr << "Error: <count> and <seed> must be numbers." << std::endl;
+        return 1;
+    }
+
+    const std::string text = SudokuBench::generateCorpus(kind, count, seed);
+    if (argc > 4) {
+        std::ofstream out(argv[4], std::ios::binary);
+        if (!out || !out.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+            std::cerr << "Error: Cannot write " << argv[4] << std::endl;
+            return 1;
+        }
+    } else {
+        std::fwrite(text.data(), 1, text.size(), stdout);
+    }
+    return 0;
+}
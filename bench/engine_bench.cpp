@@ -0,0 +1,124 @@
+// Benchmark: bitmask DFS (SudokuSolver) vs. dancing links (DlxSolver), puzzle by puzzle on
+// the same corpora. Reports the best of `repeats` runs per engine.
+//
+// Usage: engine_bench [corpus.txt ...] [--repeats=N]
+// Without files it runs the built-in hard set and a 17-clue set made by relabeling and
+// permuting two known 17-clue puzzles.
+
+#include "dlx_solver.hpp"
+#include "sudoku_solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const char* const HARD_PUZZLES[] = {
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        "52...6.........7.13...........4..8..6......5...........418.........3..2...87.....",
+        "6.....8.3.4.7.................5.4.7.3..2.....1.6.......2.....5.....8.6......1....",
+        "48.3............71.2.......7.5....6....2..8.............1.76...3.....4......5....",
+        "....14....3....2...7..........9...3.6.1.............8.2.....1.4....5.6.....7.8...",
+        "100007090030020008009600500005300900010080002600004000300000010040000007007000300",
+    };
+
+    const char* const SEVENTEEN_CLUE_SEEDS[] = {
+        "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+        "000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+    };
+
+    struct Corpus {
+        std::string name;
+        std::vector<std::string> puzzles;
+    };
+
+    // Validity-preserving transform: digit relabeling, row/column permutations within bands
+    // and stacks, band/stack permutations and an optional transpose.
+    std::string transform(const std::string& puzzle, std::mt19937& rng) {
+        int digits[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        std::shuffle(digits + 1, digits + 10, rng);
+        auto order = [&rng]() {
+            int outer[3] = {0, 1, 2}, result[9];
+            std::shuffle(outer, outer + 3, rng);
+            for (int b = 0; b < 3; ++b) {
+                int inner[3] = {0, 1, 2};
+                std::shuffle(inner, inner + 3, rng);
+                for (int k = 0; k < 3; ++k) result[b * 3 + k] = outer[b] * 3 + inner[k];
+            }
+            return std::vector<int>(result, result + 9);
+        };
+        const std::vector<int> rows = order(), cols = order();
+        const bool transpose = (rng() & 1) != 0;
+        std::string out(81, '0');
+        for (int r = 0; r < 9; ++r) {
+            for (int c = 0; c < 9; ++c) {
+                const char ch = puzzle[rows[r] * 9 + cols[c]];
+                const int d = (ch >= '1' && ch <= '9') ? digits[ch - '0'] : 0;
+                out[transpose ? c * 9 + r : r * 9 + c] = static_cast<char>('0' + d);
+            }
+        }
+        return out;
+    }
+
+    template <typename Solver>
+    double runCorpus(const Corpus& corpus, size_t repeats, size_t& solved) {
+        Solver solver;
+        double best = 1e300;
+        for (size_t rep = 0; rep < repeats; ++rep) {
+            solved = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (const std::string& p : corpus.puzzles) {
+                if (solver.initialize(p.data(), 81) && solver.solve() == SudokuApp::SolveResult::Solved) solved++;
+            }
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t repeats = 3;
+    std::vector<Corpus> corpora;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--repeats=", 0) == 0) { repeats = std::max<size_t>(1, std::stoull(arg.substr(10))); continue; }
+        Corpus corpus{arg, {}};
+        std::ifstream file(arg);
+        std::string line;
+        while (std::getline(file, line)) if (line.size() >= 81) corpus.puzzles.push_back(line.substr(0, 81));
+        if (corpus.puzzles.empty()) {
+            std::cerr << "No puzzles in '" << arg << "'." << std::endl;
+            return 1;
+        }
+        corpora.push_back(std::move(corpus));
+    }
+    if (corpora.empty()) {
+        corpora.push_back({"hard (built in)", std::vector<std::string>(std::begin(HARD_PUZZLES), std::end(HARD_PUZZLES))});
+        Corpus seventeen{"17-clue (transforms)", {}};
+        std::mt19937 rng(17);
+        for (int k = 0; k < 500; ++k) {
+            for (const char* seed : SEVENTEEN_CLUE_SEEDS) seventeen.puzzles.push_back(transform(seed, rng));
+        }
+        corpora.push_back(std::move(seventeen));
+    }
+
+    std::printf("%-28s %9s %12s %12s %8s\n", "corpus", "puzzles", "bitmask ms", "dlx ms", "dlx/bit");
+    for (const Corpus& corpus : corpora) {
+        size_t solvedBitmask = 0, solvedDlx = 0;
+        const double bitmaskMs = runCorpus<SudokuApp::SudokuSolver>(corpus, repeats, solvedBitmask);
+        const double dlxMs = runCorpus<SudokuApp::DlxSolver>(corpus, repeats, solvedDlx);
+        std::printf("%-28s %9zu %12.2f %12.2f %8.2f\n", corpus.name.c_str(), corpus.puzzles.size(), bitmaskMs, dlxMs, dlxMs / bitmaskMs);
+        if (solvedBitmask != solvedDlx) {
+            std::fprintf(stderr, "  engines disagree: %zu vs %zu solved\n", solvedBitmask, solvedDlx);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,382 @@
+// Benchmark suite: microbenchmarks of the solver kernels on fixed puzzles plus end-to-end
+// throughput of the sudoku_solver executable over synthetic corpora.
+//
+// Usage: solver_bench [--solver=<sudoku_solver>] [--corpora=<dir>] [--filter=<substring>]
+//                     [--min-time=<seconds>] [--repetitions=<n>] [--json=<results.json>]
+// The end-to-end runs need both --solver and --corpora; the directory must hold
+// <kind>.txt files written by corpus_gen (the `bench` target does all of this).
+
+#include "bench_harness.hpp"
+#include "corpus.hpp"
+
+#include "batch_solver.hpp"
+#include "dlx_solver.hpp"
+#include "solution_verifier.hpp"
+#include "sudoku_solver.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SudokuApp {
+
+    struct SolverBenchAccess {
+        static int findMRV(const SudokuSolver& solver) { return solver.findMRV(); }
+
+        static bool canPlace(const SudokuSolver& solver, int cell, int num) { return solver.canPlace(cell, num); }
+
+        static void place(SudokuSolver& solver, int cell, int num) { solver.place(cell, num); }
+
+        static void remove(SudokuSolver& solver, int cell, int num) { solver.remove(cell, num); }
+
+        // The selection loop as it was before candidate masks were maintained incrementally.
+        static int legacyScan(const SudokuSolver& solver, const uint8_t* emptyCells, int emptyCount) {
+            int minCount = 10;
+            int bestCell = -1;
+            for (int i = 0; i < emptyCount; ++i) {
+                const int cell = emptyCells[i];
+                const int row = cell / 9, col = cell % 9, box = (row / 3) * 3 + col / 3;
+                const uint16_t used = solver.rows[row] | solver.cols[col] | solver.boxes[box];
+                const int count = static_cast<int>(std::bitset<16>(~used & 0x3FEu).count());
+                if (count == 0) return -1;
+                if (count < minCount) {
+                    minCount = count;
+                    bestCell = cell;
+                    if (minCount == 1) break;
+                }
+            }
+            return bestCell;
+        }
+    };
+
+}
+
+namespace {
+
+    using SudokuApp::SolverBenchAccess;
+    using SudokuApp::SudokuSolver;
+    using SudokuBench::State;
+
+    struct PuzzleSet {
+        const char* name;
+        std::vector<std::string> puzzles;
+    };
+
+    const PuzzleSet& hardSet() {
+        static const PuzzleSet set{"hard", {
+            "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+            "52...6.........7.13...........4..8..6......5...........418.........3..2...87.....",
+            "6.....8.3.4.7.................5.4.7.3..2.....1.6.......2.....5.....8.6......1....",
+            "48.3............71.2.......7.5....6....2..8.............1.76...3.....4......5....",
+            "....14....3....2...7..........9...3.6.1.............8.2.....1.4....5.6.....7.8...",
+            "100007090030020008009600500005300900010080002600004000300000010040000007007000300",
+            "800000000003600000070090000050007000000045700000100030001000068008500010090000400",
+        }};
+        return set;
+    }
+
+    // Fixed seed, so every run measures the same puzzles.
+    PuzzleSet generatedSet(const char* name, SudokuBench::CorpusKind kind, size_t count) {
+        PuzzleSet set{name, {}};
+        const std::string text = SudokuBench::generateCorpus(kind, count, 1);
+        for (size_t pos = 0; pos < text.size();) {
+            const size_t end = text.find('\n', pos);
+            set.puzzles.push_back(text.substr(pos, end - pos));
+            pos = end + 1;
+        }
+        return set;
+    }
+
+    std::vector<const PuzzleSet*> fixedSets() {
+        static const PuzzleSet easy = generatedSet("easy", SudokuBench::CorpusKind::Easy, 64);
+        static const PuzzleSet seventeen = generatedSet("17", SudokuBench::CorpusKind::Seventeen, 64);
+        return {&hardSet(), &easy, &seventeen};
+    }
+
+    /** @brief Solvers initialized with every puzzle of `set`, for the benchmarks that need a live state. */
+    std::vector<SudokuSolver> initializedStates(const PuzzleSet& set) {
+        std::vector<SudokuSolver> states(set.puzzles.size());
+        for (size_t i = 0; i < states.size(); ++i) states[i].initialize(set.puzzles[i].data(), 81);
+        return states;
+    }
+
+    void benchInitialize(State& state, const PuzzleSet& set) {
+        SudokuSolver solver;
+        size_t next = 0;
+        for (auto _ : state) {
+            SudokuBench::doNotOptimize(solver.initialize(set.puzzles[next].data(), 81));
+            if (++next == set.puzzles.size()) next = 0;
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    void benchFindMRV(State& state, const PuzzleSet& set) {
+        const std::vector<SudokuSolver> states = initializedStates(set);
+        size_t next = 0;
+        for (auto _ : state) {
+            SudokuBench::doNotOptimize(SolverBenchAccess::findMRV(states[next]));
+            if (++next == states.size()) next = 0;
+        }
+    }
+
+    void benchFindMRVLegacyScan(State& state, const PuzzleSet& set) {
+        const std::vector<SudokuSolver> states = initializedStates(set);
+        std::vector<std::vector<uint8_t>> emptyLists(states.size());
+        for (size_t i = 0; i < states.size(); ++i) {
+            const char* grid = states[i].getSolution();
+            for (int cell = 0; cell < 81; ++cell) if (grid[cell] == '0') emptyLists[i].push_back(static_cast<uint8_t>(cell));
+        }
+        size_t next = 0;
+        for (auto _ : state) {
+            SudokuBench::doNotOptimize(SolverBenchAccess::legacyScan(states[next], emptyLists[next].data(),
+                                                                     static_cast<int>(emptyLists[next].size())));
+            if (++next == states.size()) next = 0;
+        }
+    }
+
+    // One iteration places a legal digit in the MRV cell and removes it again.
+    void benchPlaceRemove(State& state, const PuzzleSet& set) {
+        std::vector<SudokuSolver> states = initializedStates(set);
+        std::vector<std::pair<int, int>> moves;
+        for (SudokuSolver& solver : states) {
+            const int cell = SolverBenchAccess::findMRV(solver);
+            int num = 1;
+            while (cell >= 0 && num <= 9 && !SolverBenchAccess::canPlace(solver, cell, num)) num++;
+            moves.emplace_back(cell, num);
+        }
+        if (moves.empty() || moves[0].first < 0 || moves[0].second > 9) {
+            state.skipWithError("no legal move in the first puzzle");
+            return;
+        }
+        size_t next = 0;
+        for (auto _ : state) {
+            const auto move = moves[next];
+            if (move.first >= 0 && move.second <= 9) {
+                SolverBenchAccess::place(states[next], move.first, move.second);
+                SolverBenchAccess::remove(states[next], move.first, move.second);
+            }
+            if (++next == states.size()) next = 0;
+        }
+        SudokuBench::doNotOptimize(states[0]);
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template <typename Solver>
+    void benchSolve(State& state, const PuzzleSet& set) {
+        Solver solver;
+        size_t next = 0;
+        for (auto _ : state) {
+            solver.initialize(set.puzzles[next].data(), 81);
+            SudokuBench::doNotOptimize(solver.solve());
+            if (++next == set.puzzles.size()) next = 0;
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    /**
+     * @brief `count` puzzles on the grid of one `BasicSudokuSolver` instantiation: a pattern
+     * solution with its digits, the rows of each band and the columns of each stack shuffled,
+     * then about `blanks` percent of the cells emptied. Fixed seed and mt19937_64 only, as in
+     * corpus.cpp, so every run measures the same puzzles.
+     */
+    template <unsigned BoxRows, unsigned BoxCols>
+    PuzzleSet gridSet(const char* name, size_t count, unsigned blanks) {
+        using Solver = SudokuApp::BasicSudokuSolver<BoxRows, BoxCols>;
+        constexpr unsigned N = Solver::DIGITS;
+        std::mt19937_64 rng(1);
+        const auto shuffle = [&rng](unsigned* items, unsigned n) {
+            for (unsigned i = n - 1; i > 0; --i) std::swap(items[i], items[rng() % (i + 1)]);
+        };
+        PuzzleSet set{name, {}};
+        for (size_t p = 0; p < count; ++p) {
+            unsigned digits[N], rows[N], cols[N];
+            for (unsigned i = 0; i < N; ++i) digits[i] = rows[i] = cols[i] = i;
+            shuffle(digits, N);
+            for (unsigned band = 0; band < N; band += BoxRows) shuffle(rows + band, BoxRows);
+            for (unsigned stack = 0; stack < N; stack += BoxCols) shuffle(cols + stack, BoxCols);
+            std::string puzzle(Solver::CELLS, '0');
+            for (unsigned r = 0; r < N; ++r) {
+                for (unsigned c = 0; c < N; ++c) {
+                    if (rng() % 100 < blanks) continue;
+                    const unsigned value = (BoxCols * (rows[r] % BoxRows) + rows[r] / BoxRows + cols[c]) % N;
+                    puzzle[r * N + c] = Solver::symbol(digits[value] + 1);
+                }
+            }
+            set.puzzles.push_back(puzzle);
+        }
+        return set;
+    }
+
+    // The same search on every grid size the library instantiates.
+    template <unsigned BoxRows, unsigned BoxCols>
+    void benchSolveGrid(State& state, const PuzzleSet& set) {
+        using Solver = SudokuApp::BasicSudokuSolver<BoxRows, BoxCols>;
+        Solver solver;
+        size_t next = 0;
+        for (auto _ : state) {
+            solver.initialize(set.puzzles[next].data(), Solver::CELLS);
+            SudokuBench::doNotOptimize(solver.solve());
+            if (++next == set.puzzles.size()) next = 0;
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    // One iteration solves the whole set, 16 lanes at a time.
+    void benchSolveBatch(State& state, const PuzzleSet& set) {
+        SudokuApp::BatchSolver solver;
+        std::vector<const char*> pointers;
+        for (const std::string& p : set.puzzles) pointers.push_back(p.data());
+        for (auto _ : state) {
+            for (size_t first = 0; first < pointers.size(); first += SudokuApp::BATCH_LANES) {
+                const size_t count = std::min<size_t>(SudokuApp::BATCH_LANES, pointers.size() - first);
+                solver.solve(pointers.data() + first, count);
+                SudokuBench::doNotOptimize(solver.solved(0));
+            }
+        }
+        state.setItemsProcessed(state.iterations() * pointers.size());
+        state.setLabel(solver.kernelName());
+    }
+
+    /** @brief `set` with its solutions; every fourth one has two cells swapped, so a share fails. */
+    struct VerifySet {
+        std::vector<std::string> puzzles;
+        std::vector<std::string> solutions;
+    };
+
+    VerifySet verifySet(const PuzzleSet& set) {
+        VerifySet pairs;
+        SudokuSolver solver;
+        for (const std::string& p : set.puzzles) {
+            if (!solver.initialize(p.data(), 81) || solver.solve() != SudokuApp::SolveResult::Solved) continue;
+            std::string solution(solver.getSolution(), 81);
+            if (pairs.solutions.size() % 4 == 3) std::swap(solution[0], solution[40]);
+            pairs.puzzles.push_back(p);
+            pairs.solutions.push_back(solution);
+        }
+        return pairs;
+    }
+
+    // One iteration verifies the whole set, `SolutionVerifier::LANES` pairs at a time.
+    void benchVerify(State& state, const PuzzleSet& set) {
+        const VerifySet pairs = verifySet(set);
+        SudokuApp::SolutionVerifier verifier;
+        SudokuApp::VerifyResult results[SudokuApp::SolutionVerifier::LANES];
+        std::vector<const char*> puzzles;
+        std::vector<const char*> solutions;
+        for (size_t i = 0; i < pairs.puzzles.size(); ++i) {
+            puzzles.push_back(pairs.puzzles[i].data());
+            solutions.push_back(pairs.solutions[i].data());
+        }
+        for (auto _ : state) {
+            for (size_t first = 0; first < puzzles.size(); first += SudokuApp::SolutionVerifier::LANES) {
+                const size_t count = std::min(SudokuApp::SolutionVerifier::LANES, puzzles.size() - first);
+                verifier.verify(puzzles.data() + first, solutions.data() + first, count, results);
+                SudokuBench::doNotOptimize(results[0]);
+            }
+        }
+        state.setItemsProcessed(state.iterations() * puzzles.size());
+        state.setLabel(verifier.kernelName());
+    }
+
+    void benchVerifyScalar(State& state, const PuzzleSet& set) {
+        const VerifySet pairs = verifySet(set);
+        for (auto _ : state) {
+            for (size_t i = 0; i < pairs.puzzles.size(); ++i) {
+                SudokuBench::doNotOptimize(SudokuApp::verifySolution(pairs.puzzles[i].data(), pairs.solutions[i].data()));
+            }
+        }
+        state.setItemsProcessed(state.iterations() * pairs.puzzles.size());
+    }
+
+    size_t countLines(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        size_t lines = 0;
+        std::string line;
+        while (std::getline(file, line)) lines++;
+        return lines;
+    }
+
+    // One iteration runs the executable on the whole corpus with one thread. Only real time is
+    // meaningful here: cpu_time covers this process, not the child.
+    void benchEndToEnd(State& state, const std::string& solver, const std::string& corpus,
+                       const std::string& output, const std::string& engine) {
+        const size_t records = countLines(corpus);
+        if (records == 0) {
+            state.skipWithError("missing or empty corpus " + corpus + " (generate it with corpus_gen)");
+            return;
+        }
+#ifdef _WIN32
+        const char* discard = " > NUL";
+#else
+        const char* discard = " > /dev/null";
+#endif
+        const std::string command = "\"" + solver + "\" \"" + corpus + "\" \"" + output + "\" 1 --engine=" + engine + discard;
+        for (auto _ : state) {
+            if (std::system(command.c_str()) != 0) {
+                state.skipWithError("'" + command + "' failed");
+                return;
+            }
+        }
+        state.setItemsProcessed(state.iterations() * records);
+        state.setLabel("subprocess");
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string solverPath;
+    std::string corporaDir;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--solver=", 0) == 0) solverPath = arg.substr(9);
+        else if (arg.rfind("--corpora=", 0) == 0) corporaDir = arg.substr(10);
+    }
+
+    using SudokuBench::registerBenchmark;
+    for (const PuzzleSet* set : fixedSets()) {
+        const std::string suffix = std::string("/") + set->name;
+        registerBenchmark("Initialize" + suffix, [set](State& s) { benchInitialize(s, *set); });
+        registerBenchmark("FindMRV" + suffix, [set](State& s) { benchFindMRV(s, *set); });
+        registerBenchmark("FindMRVLegacyScan" + suffix, [set](State& s) { benchFindMRVLegacyScan(s, *set); });
+        registerBenchmark("PlaceRemove" + suffix, [set](State& s) { benchPlaceRemove(s, *set); });
+        registerBenchmark("Solve/bitmask" + suffix, [set](State& s) { benchSolve<SudokuSolver>(s, *set); });
+        registerBenchmark("Solve/dlx" + suffix, [set](State& s) { benchSolve<SudokuApp::DlxSolver>(s, *set); });
+        registerBenchmark("Solve/batch" + suffix, [set](State& s) { benchSolveBatch(s, *set); });
+    }
+    {
+        const PuzzleSet* easy = fixedSets()[1];
+        registerBenchmark("Verify/simd", [easy](State& s) { benchVerify(s, *easy); });
+        registerBenchmark("Verify/scalar", [easy](State& s) { benchVerifyScalar(s, *easy); });
+    }
+
+    static const PuzzleSet grid4 = gridSet<2, 2>("4x4", 64, 60);
+    static const PuzzleSet grid9 = gridSet<3, 3>("9x9", 64, 55);
+    static const PuzzleSet grid16 = gridSet<4, 4>("16x16", 16, 50);
+    static const PuzzleSet grid25 = gridSet<5, 5>("25x25", 8, 40);
+    registerBenchmark("SolveGrid/4x4", [](State& s) { benchSolveGrid<2, 2>(s, grid4); });
+    registerBenchmark("SolveGrid/9x9", [](State& s) { benchSolveGrid<3, 3>(s, grid9); });
+    registerBenchmark("SolveGrid/16x16", [](State& s) { benchSolveGrid<4, 4>(s, grid16); });
+    registerBenchmark("SolveGrid/25x25", [](State& s) { benchSolveGrid<5, 5>(s, grid25); });
+
+    if (!solverPath.empty() && !corporaDir.empty()) {
+        static const char* const KINDS[] = {"easy", "hard", "17", "invalid", "whitespace", "mixed"};
+        static const char* const ENGINES[] = {"scalar", "batch", "dlx"};
+        const std::string output = corporaDir + "/bench_output.txt";
+        for (const char* kind : KINDS) {
+            const std::string corpus = corporaDir + "/" + kind + ".txt";
+            for (const char* engine : ENGINES) {
+                registerBenchmark(std::string("EndToEnd/") + kind + "/" + engine,
+                                  [=](State& s) { benchEndToEnd(s, solverPath, corpus, output, engine); });
+            }
+        }
+    }
+
+    return SudokuBench::runBenchmarks(argc, argv);
+}
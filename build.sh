@@ -10,6 +10,17 @@ CXX_STANDARD_FLAGS="-std=c++17"
 OPTIMIZATION_FLAGS="-O3 -march=native -flto"
 LINKER_FLAGS="-lpthread"
 WARNING_FLAGS="-Wall -Wextra"
+# Search loop A/B: SUDOKU_ITERATIVE_SEARCH=0 ./build.sh builds the recursive solver.
+SEARCH_FLAGS="-DSUDOKU_ITERATIVE_SEARCH=${SUDOKU_ITERATIVE_SEARCH:-1}"
+# Instrumentation for --stats: SUDOKU_STATS=1 ./build.sh
+STATS_FLAGS="-DSUDOKU_STATS=${SUDOKU_STATS:-0}"
+# Gzip input/output through zlib: SUDOKU_ZLIB=0 ./build.sh builds without it.
+if [ "${SUDOKU_ZLIB:-1}" = "1" ]; then
+  ZLIB_FLAGS="-DSUDOKU_HAVE_ZLIB=1"
+  LINKER_FLAGS="$LINKER_FLAGS -lz"
+else
+  ZLIB_FLAGS="-DSUDOKU_HAVE_ZLIB=0"
+fi
 
 SOURCE_FILES=$(ls "$SOURCE_DIR"/*.cpp 2> /dev/null)
 
@@ -25,13 +36,16 @@ fi
 echo "Found source files in '$SOURCE_DIR':"
 for f in $SOURCE_FILES; do echo "  - $f"; done
 echo "Using header directory: '$HEADER_DIR'"
+echo "Search loop: $SEARCH_FLAGS"
+echo "Instrumentation: $STATS_FLAGS"
+echo "Gzip streams: $ZLIB_FLAGS"
 
 
 echo "Cleaning previous build artifacts and profile data..."
 rm -f "$OUTPUT_NAME" "$PROFILE_DIR"/*.gcda "$PROFILE_DIR"/*.gcno
 
 echo "Step 1: Instrumented build (with LTO)..."
-"$CXX" $OPTIMIZATION_FLAGS -fprofile-generate="$PROFILE_DIR" $CXX_STANDARD_FLAGS $WARNING_FLAGS \
+"$CXX" $OPTIMIZATION_FLAGS -fprofile-generate="$PROFILE_DIR" $CXX_STANDARD_FLAGS $WARNING_FLAGS $SEARCH_FLAGS $STATS_FLAGS $ZLIB_FLAGS \
     -o "$OUTPUT_NAME" \
     $SOURCE_FILES \
     $LINKER_FLAGS \
@@ -43,7 +57,7 @@ echo "         (Make sure 'input.txt' is present and representative)"
 rm -f output_pgo_run.txt
 
 echo "Step 3: Final optimized build using profile data (with LTO)..."
-"$CXX" $OPTIMIZATION_FLAGS -fprofile-use="$PROFILE_DIR" -fprofile-correction $CXX_STANDARD_FLAGS $WARNING_FLAGS \
+"$CXX" $OPTIMIZATION_FLAGS -fprofile-use="$PROFILE_DIR" -fprofile-correction $CXX_STANDARD_FLAGS $WARNING_FLAGS $SEARCH_FLAGS $STATS_FLAGS $ZLIB_FLAGS \
     -o "$OUTPUT_NAME" \
     $SOURCE_FILES \
     $LINKER_FLAGS \
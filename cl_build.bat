@@ -3,10 +3,14 @@ set CXX=cl.exe
 set OUTPUT_NAME=sudoku_solver.exe
 set CXX_STANDARD_FLAGS=/std:c++17 /EHsc
 set OPTIMIZATION_FLAGS=/Ox /GL /arch:AVX2 /fp:fast /MD
+if "%SUDOKU_ITERATIVE_SEARCH%"=="" set SUDOKU_ITERATIVE_SEARCH=1
+set SEARCH_FLAGS=/DSUDOKU_ITERATIVE_SEARCH=%SUDOKU_ITERATIVE_SEARCH%
+if "%SUDOKU_STATS%"=="" set SUDOKU_STATS=0
+set STATS_FLAGS=/DSUDOKU_STATS=%SUDOKU_STATS%
 set LINKER_FLAGS_INSTRUMENT=/GENPROFILE /DEBUG /INCREMENTAL:NO
 set LINKER_FLAGS_FINAL=/LTCG:PGO /INCREMENTAL:NO
 
-set SOURCE_FILES=src/main.cpp src/sudoku_solver.cpp src/worker.cpp
+set SOURCE_FILES=src/main.cpp src/batch_solver.cpp src/batch_solver_avx2.cpp src/canonical_form.cpp src/compressed_stream.cpp src/cpu_features.cpp src/cpu_topology.cpp src/dlx_solver.cpp src/input_partition.cpp src/latency_histogram.cpp src/mapped_file.cpp src/output_file.cpp src/packed_format.cpp src/parallel_search.cpp src/progress.cpp src/record_solver.cpp src/run_journal.cpp src/run_solver.cpp src/run_stats.cpp src/solution_verifier.cpp src/solve_cache.cpp src/solver_pool.cpp src/stream_pipeline.cpp src/sudoku_c_api.cpp src/sudoku_solver.cpp src/thread_pool.cpp src/worker.cpp
 
 set HEADER_FILES_DIR=headers
 
@@ -26,7 +30,7 @@ set PGO_DATABASE=%OUTPUT_NAME:.exe=.pgd%
 set PDB_DATABASE=%OUTPUT_NAME:.exe=.pdb%
 
 echo Step 1: Instrumented build for profiling...
-%CXX% %CXX_STANDARD_FLAGS% %OPTIMIZATION_FLAGS% /Fe:"%OUTPUT_NAME%" %SOURCE_FILES% /I %HEADER_FILES_DIR% /link %LINKER_FLAGS_INSTRUMENT% /PDB:"%PDB_DATABASE%"
+%CXX% %CXX_STANDARD_FLAGS% %OPTIMIZATION_FLAGS% %SEARCH_FLAGS% %STATS_FLAGS% /Fe:"%OUTPUT_NAME%" %SOURCE_FILES% /I %HEADER_FILES_DIR% /link %LINKER_FLAGS_INSTRUMENT% /PDB:"%PDB_DATABASE%"
 if errorlevel 1 (
     echo Instrumented build failed.
     exit /b 1
@@ -50,7 +54,7 @@ if errorlevel 1 (
 echo ---
 
 echo Step 3: Final optimized build using profile data [%PGO_DATABASE%]...
-%CXX% %CXX_STANDARD_FLAGS% %OPTIMIZATION_FLAGS% /Fe:"%OUTPUT_NAME%" %SOURCE_FILES% /I %HEADER_FILES_DIR% /link %LINKER_FLAGS_FINAL% /PDB:"%PDB_DATABASE%"
+%CXX% %CXX_STANDARD_FLAGS% %OPTIMIZATION_FLAGS% %SEARCH_FLAGS% %STATS_FLAGS% /Fe:"%OUTPUT_NAME%" %SOURCE_FILES% /I %HEADER_FILES_DIR% /link %LINKER_FLAGS_FINAL% /PDB:"%PDB_DATABASE%"
 if errorlevel 1 (
     echo Final PGO build failed.
     exit /b 1
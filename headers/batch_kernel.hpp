@@ -0,0 +1,145 @@
+#ifndef SUDOKU_APP_BATCH_KERNEL_HPP
+#define SUDOKU_APP_BATCH_KERNEL_HPP
+
+// Internal to the batch engine: the structure-of-arrays state and the lane-parallel
+// propagation kernel. The kernel is a template over a 16-lane uint16_t vector type so the
+// same code is instantiated for AVX2, SSE2 and plain scalar lanes; each instantiation
+// lives in its own translation unit compiled for its instruction set.
+
+#include <cstdint>
+#include <cstddef>
+
+namespace SudokuApp {
+
+    constexpr size_t BATCH_LANES = 16;
+
+    /**
+     * @brief N puzzles side by side: element [i][lane] belongs to puzzle `lane`.
+     *
+     * `cells` holds the placed digit of every cell as a single bit (1 << digit), 0 if empty.
+     * `dead` is 0xFFFF for lanes that hit a contradiction (or carry no puzzle).
+     */
+    struct BatchState {
+        alignas(32) uint16_t cells[81][BATCH_LANES];
+        alignas(32) uint16_t rows[9][BATCH_LANES];
+        alignas(32) uint16_t cols[9][BATCH_LANES];
+        alignas(32) uint16_t boxes[9][BATCH_LANES];
+        alignas(32) uint16_t dead[BATCH_LANES];
+    };
+
+    /** @brief Runs naked + hidden singles on every lane until no live lane changes. */
+    using BatchPropagateFn = void (*)(BatchState& state);
+
+    namespace BatchDetail {
+
+        struct CellUnits { uint8_t row, col, box; };
+
+        struct BatchTables {
+            CellUnits cell[81];
+            uint8_t unitCells[27][9];
+        };
+
+        static constexpr BatchTables makeBatchTables() {
+            BatchTables t{};
+            for (int i = 0; i < 81; ++i) {
+                t.cell[i].row = static_cast<uint8_t>(i / 9);
+                t.cell[i].col = static_cast<uint8_t>(i % 9);
+                t.cell[i].box = static_cast<uint8_t>((i / 27) * 3 + (i % 9) / 3);
+            }
+            for (int u = 0; u < 9; ++u) {
+                for (int k = 0; k < 9; ++k) {
+                    t.unitCells[u][k] = static_cast<uint8_t>(u * 9 + k);
+                    t.unitCells[9 + u][k] = static_cast<uint8_t>(k * 9 + u);
+                    t.unitCells[18 + u][k] = static_cast<uint8_t>(((u / 3) * 3 + k / 3) * 9 + (u % 3) * 3 + k % 3);
+                }
+            }
+            return t;
+        }
+        static constexpr BatchTables tables = makeBatchTables();
+
+        /**
+         * @brief The propagation kernel. `V` provides 16-lane uint16_t operations:
+         * load, store, set1, zero, bor, band, andnot(a, b) = ~a & b, sub, cmpeq (all-ones per
+         * equal lane), and any (true if some lane is non-zero).
+         */
+        template <typename V>
+        inline void propagate(BatchState& s) {
+            using Reg = typename V::Reg;
+            const Reg all = V::set1(0x3FE);
+            const Reg one = V::set1(1);
+            const Reg zero = V::zero();
+            Reg dead = V::load(s.dead);
+
+            auto place = [&](int cell, const CellUnits& u, Reg bits) {
+                V::store(s.cells[cell], V::bor(V::load(s.cells[cell]), bits));
+                V::store(s.rows[u.row], V::bor(V::load(s.rows[u.row]), bits));
+                V::store(s.cols[u.col], V::bor(V::load(s.cols[u.col]), bits));
+                V::store(s.boxes[u.box], V::bor(V::load(s.boxes[u.box]), bits));
+            };
+            auto candidates = [&](int cell, const CellUnits& u) {
+                const Reg used = V::bor(V::bor(V::load(s.rows[u.row]), V::load(s.cols[u.col])), V::load(s.boxes[u.box]));
+                const Reg empty = V::cmpeq(V::load(s.cells[cell]), zero);
+                return V::band(V::andnot(used, all), empty);
+            };
+
+            for (int pass = 0; pass < 81; ++pass) {
+                Reg changed = zero;
+
+                // Naked singles, Gauss-Seidel style: a placement is visible to later cells of the sweep.
+                for (int cell = 0; cell < 81; ++cell) {
+                    const CellUnits& u = tables.cell[cell];
+                    const Reg empty = V::cmpeq(V::load(s.cells[cell]), zero);
+                    const Reg cand = candidates(cell, u);
+                    const Reg none = V::cmpeq(cand, zero);
+                    dead = V::bor(dead, V::band(none, empty));
+                    const Reg single = V::andnot(none, V::cmpeq(V::band(cand, V::sub(cand, one)), zero));
+                    const Reg bits = V::band(cand, single);
+                    if (V::any(bits)) {
+                        place(cell, u, bits);
+                        changed = V::bor(changed, bits);
+                    }
+                }
+
+                // Hidden singles per unit.
+                for (int unit = 0; unit < 27; ++unit) {
+                    const uint8_t* cells = tables.unitCells[unit];
+                    Reg cand[9];
+                    Reg once = zero, twice = zero;
+                    for (int k = 0; k < 9; ++k) {
+                        cand[k] = candidates(cells[k], tables.cell[cells[k]]);
+                        twice = V::bor(twice, V::band(once, cand[k]));
+                        once = V::bor(once, cand[k]);
+                    }
+                    const CellUnits& first = tables.cell[cells[0]];
+                    const Reg placed = unit < 9 ? V::load(s.rows[first.row])
+                                     : unit < 18 ? V::load(s.cols[first.col])
+                                     : V::load(s.boxes[first.box]);
+                    const Reg covered = V::cmpeq(V::band(V::bor(once, placed), all), all);
+                    dead = V::bor(dead, V::andnot(covered, V::set1(0xFFFF)));
+
+                    const Reg hidden = V::andnot(twice, once);
+                    if (!V::any(hidden)) continue;
+                    for (int k = 0; k < 9; ++k) {
+                        const Reg bits = V::band(cand[k], hidden);
+                        if (!V::any(bits)) continue;
+                        // Two hidden digits claiming the same cell is a contradiction.
+                        const Reg multiple = V::andnot(V::cmpeq(V::band(bits, V::sub(bits, one)), zero), V::set1(0xFFFF));
+                        dead = V::bor(dead, multiple);
+                        place(cells[k], tables.cell[cells[k]], bits);
+                        changed = V::bor(changed, bits);
+                    }
+                }
+
+                if (!V::any(V::andnot(dead, changed))) break;
+            }
+            V::store(s.dead, dead);
+        }
+
+    }
+
+    /** @brief The AVX2 kernel, or nullptr if this build has no AVX2 code path. */
+    BatchPropagateFn batchPropagateAvx2();
+
+}
+
+#endif
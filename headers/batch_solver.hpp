@@ -0,0 +1,78 @@
+#ifndef SUDOKU_APP_BATCH_SOLVER_HPP
+#define SUDOKU_APP_BATCH_SOLVER_HPP
+
+#include "batch_kernel.hpp"
+#include "sudoku_solver.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace SudokuApp {
+
+    /**
+     * @brief Solves up to `LANES` puzzles at once by running constraint propagation on all of
+     * them in lockstep with SIMD (one 16-bit lane per puzzle).
+     *
+     * Most puzzles in a large input are solved by naked and hidden singles alone; those never
+     * leave the vector kernel. Lanes that stall with empty cells left (or that the kernel
+     * finds contradictory) are handed to a scalar `SudokuSolver`, starting from the grid the
+     * kernel reached, so the result is always the same as a scalar solve would decide.
+     *
+     * The kernel is picked once at runtime: AVX2 when the CPU has it and the build includes it,
+     * SSE2 otherwise on x86-64, and a plain scalar loop on other targets.
+     * Note: like `SudokuSolver`, one instance per thread.
+     */
+    class BatchSolver {
+    public:
+        static constexpr size_t LANES = BATCH_LANES;
+
+        BatchSolver();
+
+        /**
+         * @brief Solves `count` (at most `LANES`) puzzles of 81 characters each.
+         *
+         * Lane `i` holds the result for `puzzles[i]`; query it with `valid`, `solved` and
+         * `solution`.
+         */
+        void solve(const char* const puzzles[], size_t count);
+
+        /** @brief False if the puzzle in `lane` broke a rule in its givens. */
+        bool valid(size_t lane) const { return status[lane] != LaneStatus::Invalid; }
+
+        /** @brief True if the scalar search for `lane` ran out of budget. */
+        bool aborted(size_t lane) const { return status[lane] == LaneStatus::Aborted; }
+
+        /** @brief True if the puzzle in `lane` was solved. */
+        bool solved(size_t lane) const { return status[lane] == LaneStatus::Solved; }
+
+        /** @brief The 81-character solution of `lane`; only meaningful if `solved(lane)`. */
+        const char* solution(size_t lane) const { return grids[lane]; }
+
+        /** @brief Budget for the scalar search of lanes the kernel cannot finish. */
+        void setBudget(const SearchBudget& budget) { fallback.setBudget(budget); }
+
+#if SUDOKU_STATS
+        /** @brief Scalar search events of the last `solve`, summed over the lanes that needed it. */
+        const SearchStats& searchStats() const { return stats; }
+#endif
+
+        /** @brief Name of the kernel in use ("avx2", "sse2" or "scalar"). */
+        const char* kernelName() const { return name; }
+
+    private:
+        enum class LaneStatus : uint8_t { Invalid, Unsolvable, Aborted, Solved };
+
+        BatchPropagateFn kernel;
+        const char* name;
+        BatchState state;
+        SudokuSolver fallback;      ///< Finishes lanes the kernel could not complete.
+        LaneStatus status[LANES];
+        char grids[LANES][81];
+#if SUDOKU_STATS
+        SearchStats stats;
+#endif
+    };
+
+}
+
+#endif
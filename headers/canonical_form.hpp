@@ -0,0 +1,50 @@
+#ifndef SUDOKU_APP_CANONICAL_FORM_HPP
+#define SUDOKU_APP_CANONICAL_FORM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SudokuApp {
+
+    /**
+     * @brief A puzzle brought into a representative form of its symmetry class, plus the
+     * symmetry that takes it there.
+     *
+     * The symmetries are the validity-preserving ones: transposition, permuting the three
+     * bands (stacks), permuting the rows (columns) inside a band (stack) and relabelling the
+     * digits. Solutions map through the same symmetry, so one solved puzzle answers every
+     * puzzle with the same canonical form.
+     */
+    struct CanonicalForm {
+        static constexpr size_t CELLS = 81;
+
+        char cells[CELLS];      ///< Canonical puzzle: '0' for empty cells, digits relabelled by first appearance.
+        uint8_t source[CELLS];  ///< Canonical cell i is cell `source[i]` of the puzzle.
+        char toLabel[10];       ///< Puzzle digit d ('0' + d) becomes `toLabel[d]`; a bijection on '1'-'9'.
+        char fromLabel[10];     ///< The inverse of `toLabel`.
+        uint64_t hash;          ///< `canonicalHash(cells)`.
+
+        /** @brief Maps a grid of the puzzle (e.g. its solution) into canonical coordinates. */
+        void toCanonical(const char* grid, char* canonical) const;
+
+        /** @brief Maps a canonical grid back onto the puzzle. */
+        void fromCanonical(const char* canonical, char* grid) const;
+    };
+
+    /**
+     * @brief Computes the canonical form of 81 cells ('1'-'9' digits, anything else empty).
+     *
+     * Rows and columns are ordered by clue-count invariants, and only orders that tie on them
+     * are compared in full (lexicographically smallest relabelled grid wins), up to a fixed
+     * number of candidates. Highly symmetric clue patterns hit that limit; their form is then
+     * still deterministic and correct to map solutions through, but an equivalent puzzle may
+     * get a different one. Exact duplicates always get the same form.
+     */
+    void canonicalize(const char* puzzle, CanonicalForm& form);
+
+    /** @brief FNV-1a (64 bit) of 81 canonical cells. */
+    uint64_t canonicalHash(const char* cells);
+
+}
+
+#endif
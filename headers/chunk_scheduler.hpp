@@ -0,0 +1,92 @@
+#ifndef SUDOKU_APP_CHUNK_SCHEDULER_HPP
+#define SUDOKU_APP_CHUNK_SCHEDULER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SudokuApp {
+
+    /**
+     * @brief Hands out chunk indices to workers from shared atomic cursors (one per NUMA node).
+     *
+     * Workers claim the next unprocessed chunk whenever they finish one, so a run of hard
+     * puzzles only delays the worker that drew it while the others keep pulling work.
+     * Output order does not depend on who processes what: every chunk knows its output slot.
+     */
+    class ChunkScheduler {
+    public:
+        explicit ChunkScheduler(size_t chunkCount) : ChunkScheduler(chunkCount, std::vector<unsigned>{1}) {}
+
+        /**
+         * @brief Splits the chunks into one contiguous run per domain (NUMA node), sized in
+         * proportion to `weights` (the workers on each node).
+         *
+         * A worker drains its own domain's run first and only then helps with the others', so
+         * with pinned workers each node mostly reads (and first-touches) its own part of the
+         * input, in both the count and the solve pass.
+         */
+        ChunkScheduler(size_t chunkCount, const std::vector<unsigned>& weights)
+            : domainCount_(weights.empty() ? 1 : weights.size()), domains_(new Domain[domainCount_]), count_(chunkCount)
+        {
+            uint64_t total = 0;
+            for (unsigned weight : weights) total += weight;
+            uint64_t before = 0;
+            size_t begin = 0;
+            for (size_t d = 0; d < domainCount_; ++d) {
+                before += weights.empty() ? 1 : weights[d];
+                const size_t end = d + 1 == domainCount_ || total == 0 ? chunkCount : static_cast<size_t>(chunkCount * before / total);
+                domains_[d].next.store(begin, std::memory_order_relaxed);
+                domains_[d].end = end;
+                begin = end;
+            }
+        }
+
+        /**
+         * @brief Claims the next chunk, from `domain`'s run if any are left there.
+         * @param index Receives the claimed chunk index on success.
+         * @return false once every chunk has been handed out.
+         */
+        bool claim(size_t& index, size_t domain = 0) {
+            for (size_t k = 0; k < domainCount_; ++k) {
+                Domain& run = domains_[(domain + k) % domainCount_];
+                // Checked first so exhausted runs are not pushed ever further past their end.
+                if (run.next.load(std::memory_order_relaxed) >= run.end) continue;
+                index = run.next.fetch_add(1, std::memory_order_relaxed);
+                if (index < run.end) return true;
+            }
+            return false;
+        }
+
+        size_t chunkCount() const { return count_; }
+
+    private:
+        struct alignas(64) Domain {
+            std::atomic<size_t> next{0};
+            size_t end = 0;
+        };
+
+        size_t domainCount_;
+        std::unique_ptr<Domain[]> domains_;
+        size_t count_;
+    };
+
+    /** @brief Where a worker ran: its pinned CPU (-1 if unpinned) and that CPU's NUMA node. */
+    struct WorkerPlacement {
+        int cpu = -1;
+        unsigned node = 0;
+    };
+
+    /** @brief Per-worker load figures, filled in by the worker and read after it is joined. */
+    struct WorkerLoad {
+        double busySeconds = 0.0;
+        uint64_t chunks = 0;
+        uint64_t records = 0;
+        WorkerPlacement placement;
+    };
+
+}
+
+#endif
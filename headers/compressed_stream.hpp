@@ -0,0 +1,92 @@
+#ifndef SUDOKU_APP_COMPRESSED_STREAM_HPP
+#define SUDOKU_APP_COMPRESSED_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace SudokuApp {
+
+    /** Default deflate level of `--gzip`: fast enough to keep up with easy puzzles. */
+    constexpr int DEFAULT_GZIP_LEVEL = 1;
+
+    /** @brief True if this build can read and write gzip (it was built with zlib). */
+    bool gzipSupported();
+
+    /** @brief True if `data` starts with the gzip magic bytes. */
+    inline bool hasGzipMagic(const char* data, size_t len) {
+        return len >= 2 && static_cast<unsigned char>(data[0]) == 0x1F && static_cast<unsigned char>(data[1]) == 0x8B;
+    }
+
+    /** @brief True if the file `filename` starts with the gzip magic bytes. */
+    bool startsWithGzipMagic(const std::string& filename);
+
+    /**
+     * @brief Compresses text into independent gzip members in the BGZF layout (as written by
+     * `bgzip`): each member holds at most 65280 input bytes and records its own compressed size
+     * in a `BC` extra field.
+     *
+     * Concatenated members are a valid gzip stream for any gzip reader, so every worker can
+     * compress its own output and the writer only appends. `GzipReader` uses the sizes to find
+     * the members without inflating them and decompresses them in parallel.
+     * One instance per thread; it keeps its deflate state between calls.
+     */
+    class GzipBlockCompressor {
+    public:
+        explicit GzipBlockCompressor(int level = DEFAULT_GZIP_LEVEL);
+        ~GzipBlockCompressor();
+
+        GzipBlockCompressor(const GzipBlockCompressor&) = delete;
+        GzipBlockCompressor& operator=(const GzipBlockCompressor&) = delete;
+
+        /** @brief Appends `len` bytes of `data` to `out` as gzip members. @return false if deflate failed. */
+        bool compress(const char* data, size_t len, std::string& out);
+
+        /** @brief Appends the empty member that ends a BGZF file (readers use it to tell a complete file from a cut one). */
+        static void appendEndMember(std::string& out);
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+    };
+
+    /**
+     * @brief Reads a gzip stream from `file` and returns the decompressed bytes in order.
+     *
+     * Members in the BGZF layout (`GzipBlockCompressor`, `bgzip`) are read ahead in batches and
+     * inflated on a pool of `threads` threads, started with the reader, while the caller consumes
+     * the previous batch. Other
+     * gzip streams cannot be split before they are inflated and go through one inflater (any
+     * number of concatenated members). Bytes after the last member that are not a gzip member
+     * are ignored with a warning, as `gzip -d` does.
+     */
+    class GzipReader {
+    public:
+        /**
+         * @param prefix The first `prefixLen` bytes of the stream, already read from `file`.
+         * @param quiet Print nothing: for a caller that only peeks at the start of the stream and
+         * leaves reporting errors to the reader that reads all of it.
+         */
+        GzipReader(std::FILE* file, const char* prefix, size_t prefixLen, unsigned threads, bool quiet = false);
+        ~GzipReader();
+
+        GzipReader(const GzipReader&) = delete;
+        GzipReader& operator=(const GzipReader&) = delete;
+
+        /**
+         * @brief Decompresses up to `size` bytes into `buffer`.
+         * @return Bytes stored, 0 at the end of the stream, -1 on an error (printed to std::cerr
+         * unless `quiet`).
+         */
+        long long read(char* buffer, size_t size);
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+    };
+
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef SUDOKU_APP_CPU_FEATURES_HPP
+#define SUDOKU_APP_CPU_FEATURES_HPP
+
+namespace SudokuApp {
+
+    /**
+     * @brief True if the CPU running the process supports AVX2 and the OS saves the YMM state.
+     *
+     * Checked once and cached; used to pick SIMD kernels at runtime so one binary runs on
+     * hosts with and without AVX2. Always false on non-x86 targets.
+     */
+    bool cpuHasAvx2();
+
+}
+
+#endif
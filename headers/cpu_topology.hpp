@@ -0,0 +1,58 @@
+#ifndef SUDOKU_APP_CPU_TOPOLOGY_HPP
+#define SUDOKU_APP_CPU_TOPOLOGY_HPP
+
+#include <vector>
+
+namespace SudokuApp {
+
+    /** @brief One logical CPU (hardware thread) the process may run on. */
+    struct LogicalCpu {
+        unsigned id = 0;        ///< OS CPU number, as used by `sched_setaffinity`.
+        unsigned core = 0;      ///< Dense physical core index; SMT siblings share it.
+        unsigned node = 0;      ///< NUMA node id (0 without NUMA information).
+    };
+
+    /**
+     * @brief The CPUs available to the process, grouped into physical cores and NUMA nodes.
+     *
+     * On Linux it is read from `/sys/devices/system/cpu` (core and package ids) and
+     * `/sys/devices/system/node` (node cpu lists), restricted to the process affinity mask,
+     * so it honours `taskset` and cgroup cpusets. Elsewhere, or if sysfs is missing, every
+     * hardware thread counts as its own core on node 0 and `detected()` is false.
+     */
+    class CpuTopology {
+    public:
+        /** @brief Reads the topology of the running host (a few hundred small file reads on large hosts). */
+        static CpuTopology detect();
+
+        const std::vector<LogicalCpu>& cpus() const { return cpus_; }
+        unsigned physicalCores() const { return cores_; }
+        /** @brief NUMA node ids that have at least one available CPU, ascending. */
+        const std::vector<unsigned>& nodes() const { return nodes_; }
+        bool detected() const { return detected_; }
+
+        /**
+         * @brief CPUs for `threads` workers, in the order workers should take them.
+         *
+         * One CPU per physical core first, dealt round-robin over the NUMA nodes so a few
+         * threads still spread across sockets; SMT siblings only once every core has a thread.
+         * Wraps around when there are more threads than CPUs.
+         */
+        std::vector<LogicalCpu> placement(unsigned threads) const;
+
+    private:
+        std::vector<LogicalCpu> cpus_;
+        std::vector<unsigned> nodes_;
+        unsigned cores_ = 0;
+        bool detected_ = false;
+    };
+
+    /**
+     * @brief Binds the calling thread to logical CPU `cpu`.
+     * @return false if the OS refused or pinning is not supported on this platform.
+     */
+    bool pinCurrentThread(unsigned cpu);
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef SUDOKU_APP_DLX_SOLVER_HPP
+#define SUDOKU_APP_DLX_SOLVER_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include "search_budget.hpp"
+#include "search_stats.hpp"
+
+namespace SudokuApp {
+
+    /**
+     * @brief Solves Sudoku puzzles as an exact-cover problem with Knuth's Algorithm X
+     * (dancing links).
+     *
+     * The 729 candidate placements (cell, digit) are rows and the 324 constraints (cell filled,
+     * digit in row, digit in column, digit in box) are columns. All nodes live in one
+     * preallocated array with 16-bit links, so the whole matrix is ~32 KB and is built only once
+     * per instance: every cover is undone afterwards, so the next `initialize` starts from the
+     * full matrix again.
+     *
+     * Branching on the column with the fewest rows left is the same as picking the most
+     * constrained cell or the digit with the fewest places in a unit, which is what keeps this
+     * backend stable on sparse (17-clue) puzzles.
+     * Note: Same interface and threading rules as `SudokuSolver` (one instance per thread).
+     */
+    class DlxSolver {
+    public:
+        DlxSolver();
+
+        /**
+         * @brief Loads a puzzle; same contract as `SudokuSolver::initialize`.
+         * @return false if `len` is not 81 or the givens break a rule.
+         */
+        bool initialize(const char* puzzle_data, size_t len);
+
+        /**
+         * @brief Searches for a solution of the initialized puzzle.
+         * @return `Solved` (solution available through `getSolution`), `Unsolvable`, or
+         *         `Aborted` if the budget ran out.
+         */
+        SolveResult solve();
+
+        /** @brief Same as `SudokuSolver::setBudget`; a node is one row selection. */
+        void setBudget(const SearchBudget& budget) { this->budget = budget; }
+
+#if SUDOKU_STATS
+        /** @brief Search events of the last `solve`; a guess is a row picked from a column with alternatives. */
+        const SearchStats& searchStats() const { return stats; }
+#endif
+
+        /** @brief The 81-character grid: the solution after a successful `solve`, else the givens. */
+        const char* getSolution() const;
+
+    private:
+        static constexpr int COLUMNS = 324;
+        static constexpr int ROWS = 729;
+        static constexpr int ROOT = 0;
+        static constexpr int FIRST_ROW_NODE = COLUMNS + 1;       ///< Headers are nodes 1..324.
+        static constexpr int NODES = FIRST_ROW_NODE + ROWS * 4;
+
+        uint16_t left[NODES];
+        uint16_t right[NODES];
+        uint16_t up[NODES];
+        uint16_t down[NODES];
+        uint16_t column[NODES];         ///< Header node of each node's column.
+        uint16_t size[COLUMNS + 1];     ///< Rows left in each column, indexed by header node.
+
+        char grid[81];
+
+        // Rows selected so far, givens first, then one per search level. Each is undone in
+        // reverse order when the next puzzle is loaded.
+        uint16_t selected[81];
+        int givenCount = 0;
+        int selectedCount = 0;
+
+        SearchBudget budget;
+        BudgetTracker tracker;
+#if SUDOKU_STATS
+        SearchStats stats;
+#endif
+
+        void cover(int header);
+
+        void uncover(int header);
+
+        void selectRow(int node);
+
+        void unselectRow(int node);
+
+        int chooseColumn() const;
+
+        void restore();
+    };
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SUDOKU_APP_INPUT_PARTITION_HPP
+#define SUDOKU_APP_INPUT_PARTITION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SudokuApp {
+
+    /**
+     * @brief A half-open byte range [begin, end) of the input file.
+     *
+     * `begin` always points at the first byte of a line (or is 0), so a worker can
+     * seek straight to it and start reading whole lines. `end` is the `begin` of the
+     * next range (or the file size for the last one).
+     */
+    struct ByteRange {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+    };
+
+    /**
+     * @brief A unit of work: a newline-aligned byte range plus its place in the output.
+     *
+     * `firstRecord` is the index of the range's first record in the whole input, which is
+     * also the index of its first output slot.
+     */
+    struct InputChunk {
+        ByteRange range;
+        uint64_t firstRecord = 0;
+        uint64_t recordCount = 0;
+    };
+
+    /**
+     * @brief Queries the size of the input file with a single stat call.
+     *
+     * @param filename Path of the input file.
+     * @param size Receives the file size in bytes on success.
+     * @return true if the file exists and its size could be determined.
+     * @return false otherwise (an error is printed to stderr).
+     */
+    bool queryInputSize(const std::string& filename, uint64_t& size);
+
+    /**
+     * @brief Splits the input file into at most `parts` newline-aligned byte ranges.
+     *
+     * The file is cut at `size * i / parts` and every cut is moved forward to the byte
+     * following the next '\n', so only a few bytes around each cut are read. Ranges that
+     * collapse to nothing (e.g. a single very long line) are dropped.
+     *
+     * @param filename Path of the input file.
+     * @param fileSize Size of the file as returned by `queryInputSize`.
+     * @param parts Desired number of ranges.
+     * @return The non-empty ranges in file order, covering [0, fileSize).
+     */
+    std::vector<ByteRange> partitionInput(const std::string& filename, uint64_t fileSize, uint64_t parts);
+
+    /**
+     * @brief Same as the file overload, but probes the cuts through a mapping of the input.
+     */
+    std::vector<ByteRange> partitionInput(const char* data, uint64_t fileSize, uint64_t parts);
+
+    /**
+     * @brief Counts the records (lines) in `range` of a mapped input.
+     *
+     * Every '\n' ends a record; a non-empty tail without a trailing '\n' at the end of the
+     * file is one more record. Runs at memchr speed, so counting all ranges in parallel
+     * costs a fraction of a single solving pass.
+     *
+     * @param data Start of the mapped file.
+     * @param fileSize Size of the mapped file.
+     * @param range The range to count.
+     * @return The number of records that start in `range`.
+     */
+    uint64_t countRecords(const char* data, uint64_t fileSize, ByteRange range);
+
+    /**
+     * @brief Same as the mapped overload, but reads `range` of `filename` in blocks.
+     * @param count Receives the number of records that start in `range` on success.
+     * @return false if the range cannot be read in full (an error is printed to stderr).
+     */
+    bool countRecords(const std::string& filename, uint64_t fileSize, ByteRange range, uint64_t& count);
+
+    /**
+     * @brief Side length of the grids whose lines hold `cells` non-blank characters.
+     *
+     * 16, 256 or 625 cells mean 4x4, 16x16 or 25x25 grids; anything else is taken for 9x9,
+     * whose own checks then report it.
+     * @return 4, 9, 16 or 25.
+     */
+    unsigned gridSizeForCells(size_t cells);
+
+    /**
+     * @brief Guesses the side length of the grids in `filename` from its first eight non-blank
+     * lines (`gridSizeForCells`), which must agree; a gzip file is inflated up to those lines.
+     * An unreadable or empty file is taken for 9x9.
+     * @return 4, 9, 16 or 25; 0 if the lines disagree (a malformed record, or mixed sizes).
+     */
+    unsigned detectGridSize(const std::string& filename);
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SUDOKU_APP_LATENCY_HISTOGRAM_HPP
+#define SUDOKU_APP_LATENCY_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace SudokuApp {
+
+    /**
+     * @brief HDR-style log-linear histogram of non-negative integers (nanoseconds here).
+     *
+     * Values below 16 get a bucket each; above that every power of two is split into 16
+     * buckets, so any recorded value is known to within 1/16 (6.25%) over the whole 64-bit
+     * range with a fixed 976-bucket array. Recording is a couple of instructions and never
+     * allocates; histograms of different threads are combined with `merge`.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr int SUB_BITS = 4;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+        static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+        void record(uint64_t value) {
+            counts[indexOf(value)]++;
+            total++;
+            sum += value;
+            if (value > maximum) maximum = value;
+        }
+
+        void merge(const LatencyHistogram& other);
+
+        /**
+         * @brief The value at or below which `percent` % of the recorded values lie.
+         * Reported as the upper end of the matching bucket (never below the true value).
+         */
+        uint64_t percentile(double percent) const;
+
+        uint64_t count() const { return total; }
+        uint64_t max() const { return maximum; }
+        double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+    private:
+        static int indexOf(uint64_t value) {
+            if (value < SUB_BUCKETS) return static_cast<int>(value);
+#if defined(_MSC_VER)
+            unsigned long msb;
+            _BitScanReverse64(&msb, value);
+#else
+            const int msb = 63 - __builtin_clzll(value);
+#endif
+            const int shift = static_cast<int>(msb) - SUB_BITS;
+            return ((shift + 1) << SUB_BITS) + static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        }
+
+        static uint64_t upperBound(int index);
+
+        uint64_t counts[BUCKETS] = {0};
+        uint64_t total = 0;
+        uint64_t sum = 0;
+        uint64_t maximum = 0;
+    };
+
+}
+
+#endif
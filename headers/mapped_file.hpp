@@ -0,0 +1,63 @@
+#ifndef SUDOKU_APP_MAPPED_FILE_HPP
+#define SUDOKU_APP_MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace SudokuApp {
+
+    /**
+     * @brief Read-only memory mapping of a whole input file.
+     *
+     * The mapping is advised for sequential access so the kernel reads ahead aggressively.
+     * Consumers that walk the file once can call `release` on the part they are done with;
+     * the pages stay in the page cache but no longer count towards the process RSS, which
+     * keeps the resident footprint flat regardless of the file size.
+     * Note: Instances are move-only; the mapping is unmapped on destruction.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /**
+         * @brief Maps `filename` read-only. Any previous mapping is closed first.
+         *
+         * @param filename Path of the file to map.
+         * @return true on success (an empty file is a successful, empty mapping).
+         * @return false if the file cannot be opened or mapped (an error is printed to stderr).
+         */
+        bool open(const std::string& filename);
+
+        /** @brief Unmaps the file. Safe to call on a closed instance. */
+        void close();
+
+        const char* data() const { return data_; }
+        uint64_t size() const { return size_; }
+
+        /**
+         * @brief Drops the resident pages overlapping [begin, end).
+         *
+         * Only a hint: the data remains readable and is faulted back in from the page
+         * cache if touched again, so releasing a page shared with a range another thread
+         * is still reading is harmless. A no-op on platforms without an equivalent call.
+         */
+        void release(uint64_t begin, uint64_t end) const;
+
+    private:
+        const char* data_ = nullptr;
+        uint64_t size_ = 0;
+#if defined(_WIN32)
+        void* fileHandle_ = nullptr;
+        void* mappingHandle_ = nullptr;
+#endif
+    };
+
+}
+
+#endif
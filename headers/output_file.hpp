@@ -0,0 +1,61 @@
+#ifndef SUDOKU_APP_OUTPUT_FILE_HPP
+#define SUDOKU_APP_OUTPUT_FILE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace SudokuApp {
+
+    /**
+     * @brief Output file written with positional (offset-addressed) writes.
+     *
+     * The file is created at its final size up front, so workers that know where their
+     * records belong can write them concurrently without any coordination and without
+     * intermediate part files.
+     * Note: `writeAt` is safe to call from several threads as long as the ranges do not overlap.
+     */
+    class PositionalOutputFile {
+    public:
+        PositionalOutputFile() = default;
+        ~PositionalOutputFile();
+
+        PositionalOutputFile(const PositionalOutputFile&) = delete;
+        PositionalOutputFile& operator=(const PositionalOutputFile&) = delete;
+
+        /**
+         * @brief Creates (or truncates) `filename` and preallocates `size` bytes.
+         *
+         * `writeAt` offsets count from `origin`, which leaves room for a header that is
+         * written separately (packed output). With `keep` an existing file keeps its contents
+         * (a resumed run fills in the records that are missing).
+         *
+         * @return true on success.
+         * @return false if the file cannot be created or sized (an error is printed to stderr).
+         */
+        bool open(const std::string& filename, uint64_t size, uint64_t origin = 0, bool keep = false);
+
+        /** @brief Closes the file. Safe to call on a closed instance. */
+        void close();
+
+        /**
+         * @brief Writes `len` bytes at `origin + offset`, retrying short writes.
+         * @return true if every byte was written.
+         */
+        bool writeAt(uint64_t offset, const char* data, size_t len) const;
+
+        /** @brief Flushes what has been written to the device. Safe to call alongside `writeAt`. */
+        bool sync() const;
+
+    private:
+        uint64_t origin_ = 0;
+#if defined(_WIN32)
+        void* handle_ = nullptr;
+#else
+        int fd_ = -1;
+#endif
+    };
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef SUDOKU_APP_PACKED_FORMAT_HPP
+#define SUDOKU_APP_PACKED_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SudokuApp {
+
+    struct RecordMarkers;
+
+    /**
+     * Packed puzzle files: a 64-byte header, fixed-size records and a block index, all
+     * little-endian.
+     *
+     * A record is the 81 cells as 4-bit values, two per byte (cell 2k in the low nibble of
+     * byte k, cell 2k+1 in the high one): 0 is an empty cell, 1-9 a digit. 41 bytes instead
+     * of 82 for a text line. A record with a nibble above 9 is malformed (the converter writes
+     * all 0xFF for lines that do not hold 81 cells, so record N still is line N). Solver
+     * output adds a status byte (`RecordStatus`) to every record; records that are not solved
+     * keep the puzzle as it was given.
+     *
+     * The index after the records has one entry per block of `blockRecords` records, with the
+     * block's offset and an FNV-1a checksum, so a reader can seek to any block and check it.
+     */
+    constexpr size_t PACKED_CELLS_SIZE = 41;
+    constexpr size_t PACKED_STATUS_RECORD_SIZE = PACKED_CELLS_SIZE + 1;
+    constexpr uint32_t DEFAULT_PACKED_BLOCK_RECORDS = 4096;
+    constexpr uint16_t PACKED_VERSION = 1;
+    constexpr uint16_t PACKED_HAS_STATUS = 1;  ///< Header flag: records carry a status byte.
+
+    struct PackedHeader {
+        char magic[8];              ///< "SUDOKUPK"
+        uint16_t version;
+        uint16_t flags;
+        uint32_t recordSize;        ///< 41, or 42 with PACKED_HAS_STATUS.
+        uint64_t recordCount;
+        uint32_t blockRecords;
+        uint32_t blockCount;
+        uint64_t indexOffset;       ///< File offset of the block index.
+        uint8_t reserved[24];
+    };
+    static_assert(sizeof(PackedHeader) == 64, "the header is 64 bytes on disk");
+
+    struct PackedBlock {
+        uint64_t offset;            ///< File offset of the block's first record.
+        uint32_t records;
+        uint32_t checksum;          ///< FNV-1a over the block's record bytes.
+    };
+    static_assert(sizeof(PackedBlock) == 16, "index entries are 16 bytes on disk");
+
+    /** @brief Header for `records` records; `recordSize` and the index offset follow from `flags`. */
+    PackedHeader makePackedHeader(uint64_t records, uint16_t flags, uint32_t blockRecords = DEFAULT_PACKED_BLOCK_RECORDS);
+
+    /** @brief Total file size for `header`: header, records and index. */
+    uint64_t packedFileSize(const PackedHeader& header);
+
+    /** @brief True if `data` starts with the packed-file magic. */
+    bool hasPackedMagic(const char* data, uint64_t size);
+
+    /**
+     * @brief Checks the header and the index layout of a packed file held in memory.
+     * @return false (with an error on stderr) if the file is truncated or inconsistent.
+     */
+    bool readPackedHeader(const char* data, uint64_t size, PackedHeader& header);
+
+    /** @brief Checks every block of a packed file against its index checksum. */
+    bool verifyPackedBlocks(const char* data, const PackedHeader& header);
+
+    /** @brief Packs 81 cells ('1'-'9' digits, anything else empty) into 41 bytes. */
+    void packCells(const char* puzzle, uint8_t* packed);
+
+    /** @brief Fills a record with the malformed pattern (all 0xFF). */
+    void markMalformed(uint8_t* packed);
+
+    /**
+     * @brief Unpacks 41 bytes into 81 cell values (0-9) with SSE2 where available.
+     * @return false if the record is malformed (a nibble above 9); `cells` is then unspecified.
+     */
+    bool unpackCells(const uint8_t* packed, uint8_t* cells);
+
+    /** @brief Same as `unpackCells`, but as the solver's text cells ('0' for empty). */
+    bool unpackText(const uint8_t* packed, char* text);
+
+    /** @brief FNV-1a (32 bit) of `len` bytes. */
+    uint32_t blockChecksum(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Writes the header and the block index of a packed file whose records are already
+     * in place (the solver's workers write them at their offsets). Reads the records back once
+     * to checksum the blocks.
+     */
+    bool finishPackedFile(const std::string& filename, const PackedHeader& header);
+
+    /**
+     * @brief Converts a text puzzle file (one puzzle per line) into a packed file.
+     * Lines are cleaned up like the solver does (CRLF, blanks); other lines become malformed records.
+     */
+    bool packTextFile(const std::string& inputFilename, const std::string& outputFilename,
+                      uint32_t blockRecords = DEFAULT_PACKED_BLOCK_RECORDS);
+
+    /**
+     * @brief Converts a packed file back into text, one 82-byte line per record.
+     *
+     * Malformed records and, with status bytes, records that are not solved become the
+     * matching entry of `markers`, so the text matches what the solver writes for the same input.
+     */
+    bool unpackTextFile(const std::string& inputFilename, const std::string& outputFilename, const RecordMarkers& markers);
+
+}
+
+#endif
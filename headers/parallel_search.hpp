@@ -0,0 +1,107 @@
+#ifndef SUDOKU_APP_PARALLEL_SEARCH_HPP
+#define SUDOKU_APP_PARALLEL_SEARCH_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "search_budget.hpp"
+#include "sudoku_solver.hpp"
+#include "thread_pool.hpp"
+
+namespace SudokuApp {
+
+    /**
+     * @brief Searches a single puzzle with every thread of a pool.
+     *
+     * The puzzle first gets a short sequential search on the calling thread; most puzzles end
+     * there. Otherwise its search tree is cut into subproblems: copies of the solver with the
+     * first few guesses placed (`SudokuSolver::branchCell` / `assume`). Each worker keeps a
+     * deque of them, takes its newest one and steals the oldest (largest) one from another
+     * worker when it runs dry. A worker splits the subproblem it took one level further
+     * instead of searching it while fewer than `SPLIT_TASKS_PER_WORKER` per worker are
+     * waiting, so the queues refill as they drain and no worker idles behind a long subtree.
+     *
+     * The searches share a cancel flag through their `SearchBudget`: it is raised once a
+     * solution is found (or the count limit is reached) and stops the other workers within
+     * `BudgetTracker::CHECK_INTERVAL` nodes. The caller's budget covers the whole search: the
+     * time limit is one deadline, and each subproblem gets the nodes the finished ones left
+     * over, so the node limit holds only roughly (up to one budget per worker running at once).
+     *
+     * With several solutions, which one `solve` returns depends on timing. One search at a time.
+     */
+    class ParallelSearch {
+    public:
+        /** Sequential nodes before a puzzle is split; easy puzzles never reach the pool. */
+        static constexpr uint64_t SEQUENTIAL_NODES = 4 * BudgetTracker::CHECK_INTERVAL;
+        static constexpr unsigned SPLIT_TASKS_PER_WORKER = 8;
+        static constexpr unsigned MAX_SPLIT_DEPTH = 24;
+
+        explicit ParallelSearch(ThreadPool& pool);
+
+        ParallelSearch(const ParallelSearch&) = delete;
+        ParallelSearch& operator=(const ParallelSearch&) = delete;
+
+        /**
+         * @brief Solves the puzzle `root` was initialized with (`root` is left in an unspecified state).
+         * @param solution Receives the 81 cells when the result is `Solved`.
+         */
+        SolveResult solve(SudokuSolver& root, const SearchBudget& budget, char* solution);
+
+        /**
+         * @brief Counts the solutions of `root`'s puzzle up to `limit`, like `SudokuSolver::countSolutions`.
+         * @param aborted Set if the budget ran out first; the count is then a lower bound.
+         */
+        uint64_t countSolutions(SudokuSolver& root, uint64_t limit, const SearchBudget& budget, bool& aborted);
+
+    private:
+        struct Task {
+            SudokuSolver state;
+            unsigned depth = 0;
+        };
+
+        struct alignas(64) Queue {
+            std::mutex mutex;
+            std::deque<std::unique_ptr<Task>> tasks;
+        };
+
+        uint64_t search(SudokuSolver& root, uint64_t limit, const SearchBudget& budget, char* solution, bool& aborted);
+
+        void work(unsigned worker);
+
+        std::unique_ptr<Task> take(unsigned worker);
+
+        void push(unsigned worker, std::unique_ptr<Task> task);
+
+        void process(unsigned worker, Task& task);
+
+        /** @brief Adds `count` solutions found in a subtree; `grid` is one of them (or null). */
+        void found(uint64_t count, const char* grid);
+
+        SearchBudget budgetFor();
+
+        ThreadPool& pool;
+        std::unique_ptr<Queue[]> queues;
+
+        // State of the running search.
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> outstanding{0};   ///< Tasks queued or being worked on.
+        std::atomic<uint64_t> queued{0};
+        std::atomic<uint64_t> solutions{0};
+        std::atomic<uint64_t> nodesUsed{0};
+        std::atomic<bool> budgetHit{false};
+        std::mutex solutionMutex;
+        bool haveSolution = false;
+        char* solutionOut = nullptr;
+        uint64_t limit = 1;
+        SearchBudget budget;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SUDOKU_APP_PROGRESS_HPP
+#define SUDOKU_APP_PROGRESS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace SudokuApp {
+
+    /**
+     * @brief The records one worker has handled, on a cache line of its own.
+     *
+     * Only the owning worker writes its counters, so a plain load and store replaces the
+     * locked read-modify-write of a shared atomic, and no other core ever needs the line
+     * except the reporter reading it a few times a minute.
+     */
+    struct alignas(64) WorkerProgress {
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> solved{0};
+
+        void addProcessed() { processed.store(processed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+        void addSolved() { solved.store(solved.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    };
+
+    /** @brief One `WorkerProgress` per worker; the totals are summed on demand. */
+    class ProgressCounters {
+    public:
+        explicit ProgressCounters(size_t workers) : slots(new WorkerProgress[workers == 0 ? 1 : workers]), count(workers == 0 ? 1 : workers) {}
+
+        WorkerProgress& operator[](size_t worker) { return slots[worker]; }
+
+        size_t size() const { return count; }
+        uint64_t processed() const;
+        uint64_t solved() const;
+
+    private:
+        std::unique_ptr<WorkerProgress[]> slots;
+        size_t count;
+    };
+
+    /** Default seconds between progress reports. */
+    constexpr double DEFAULT_PROGRESS_SECONDS = 10.0;
+
+    /** @brief How a run reports progress while it is going. */
+    struct ProgressOptions {
+        double intervalSeconds = 0.0;   ///< 0 = no reporting.
+        std::string statusFile;         ///< Non-empty: written at every report instead of printing to stderr.
+
+        bool enabled() const { return intervalSeconds > 0.0; }
+    };
+
+    /**
+     * @brief Background thread that sums `ProgressCounters` every `intervalSeconds` and reports
+     * the records done, the rate over the last interval, and (with a known total) the percent
+     * complete and an ETA from the average rate so far.
+     *
+     * Reports go to stderr as one line each, or replace `statusFile` (a small JSON object,
+     * written next to it and renamed over it, so a reader never sees half a file). The status
+     * file gets a last report with `"done": true` when the reporter stops. Does nothing when
+     * the options are not `enabled`.
+     */
+    class ProgressReporter {
+    public:
+        /** @brief Starts reporting; `total` is the number of records, 0 if not known up front. */
+        ProgressReporter(const ProgressCounters& counters, uint64_t total, const ProgressOptions& options);
+
+        /** @brief Same as `stop`. */
+        ~ProgressReporter();
+
+        ProgressReporter(const ProgressReporter&) = delete;
+        ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+        /** @brief Stops the thread and writes the final status. Safe to call more than once. */
+        void stop();
+
+    private:
+        void run();
+
+        void report(bool done);
+
+        const ProgressCounters& counters;
+        const uint64_t total;
+        const ProgressOptions options;
+        const std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point lastTime;
+        uint64_t lastProcessed = 0;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+        std::thread thread;
+    };
+
+}
+
+#endif
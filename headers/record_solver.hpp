@@ -0,0 +1,264 @@
+#ifndef SUDOKU_APP_RECORD_SOLVER_HPP
+#define SUDOKU_APP_RECORD_SOLVER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "batch_solver.hpp"
+#include "canonical_form.hpp"
+#include "dlx_solver.hpp"
+#include "packed_format.hpp"
+#include "progress.hpp"
+#include "run_stats.hpp"
+#include "search_budget.hpp"
+#include "sudoku_solver.hpp"
+
+namespace SudokuApp {
+
+    class ParallelSearch;
+    class SolveCache;
+
+    constexpr size_t PUZZLE_SIZE = 81;
+
+    /** Every input record produces exactly one output record of this size (81 cells + '\n'). */
+    constexpr size_t OUTPUT_RECORD_SIZE = PUZZLE_SIZE + 1;
+
+    /**
+     * @brief Record size in solution-count mode: the count, zero-padded to the number of
+     * digits of `limit`, plus '\n' (2 bytes for the uniqueness check, limit 2).
+     */
+    inline size_t countRecordSize(uint64_t limit) {
+        size_t digits = 1;
+        while (limit >= 10) { limit /= 10; ++digits; }
+        return digits + 1;
+    }
+
+    /** @brief Outcome of a single input record. */
+    enum class RecordStatus : uint8_t {
+        Solved,     ///< The record was solved; its solution is written.
+        Invalid,    ///< Wrong length after stripping whitespace, or conflicting clues.
+        Unsolvable, ///< Well-formed, but the search found no solution.
+        Aborted     ///< The search budget ran out before a verdict.
+    };
+
+    /**
+     * @brief The 81-character sentinel records written in place of a solution.
+     *
+     * Keeping a record for every failed puzzle is what keeps output line N aligned with
+     * input line N. Markers never contain '\n' and are never a valid solution, so
+     * downstream consumers can tell them apart with a single character check.
+     */
+    struct RecordMarkers {
+        std::array<char, PUZZLE_SIZE> invalid;
+        std::array<char, PUZZLE_SIZE> unsolvable;
+        std::array<char, PUZZLE_SIZE> aborted;
+
+        /** @brief Defaults: 'X' repeated for invalid records, '0' for unsolvable ones, '?' for aborted ones. */
+        RecordMarkers();
+
+        /** @brief The marker for a failed status (`status` must not be `Solved`). */
+        const char* forStatus(RecordStatus status) const {
+            switch (status) {
+                case RecordStatus::Invalid: return invalid.data();
+                case RecordStatus::Aborted: return aborted.data();
+                default: return unsolvable.data();
+            }
+        }
+
+        /**
+         * @brief Parses a marker given on the command line.
+         *
+         * A single character is repeated 81 times; an 81-character string is used verbatim.
+         *
+         * @return false if `spec` has any other length, contains '\n', or is a full
+         *         81-digit grid (which could be mistaken for a solution).
+         */
+        static bool parse(const std::string& spec, std::array<char, PUZZLE_SIZE>& marker);
+    };
+
+    /** @brief Which solver a worker runs records through. */
+    enum class SolverEngine : uint8_t {
+        Scalar, ///< One puzzle at a time with `SudokuSolver`.
+        Batch,  ///< `BatchSolver::LANES` puzzles at a time, propagated with SIMD.
+        Dlx     ///< One puzzle at a time with `DlxSolver` (exact cover).
+    };
+
+    /** @brief Layout of the output records. */
+    enum class OutputFormat : uint8_t {
+        Text,   ///< 81 characters + '\n', failed records as their marker.
+        Packed  ///< 41 packed cells + status byte (packed_format.hpp); failed records keep the puzzle.
+    };
+
+    /** @brief How a worker solves records. */
+    struct SolveOptions {
+        SolverEngine engine = SolverEngine::Scalar;
+        OutputFormat output = OutputFormat::Text;   ///< Packed output is solve mode only (no `countLimit`).
+        uint64_t countLimit = 0;        ///< Non-zero: count solutions up to this instead of solving.
+        SearchBudget budget;            ///< Per-puzzle limit for the first pass.
+        bool retryAborted = false;      ///< Retry aborted puzzles with `retryBudget` after the first pass.
+        SearchBudget retryBudget;
+        SolveCache* cache = nullptr;    ///< Shared verdicts of earlier (equivalent) puzzles; unused in count mode.
+        ParallelSearch* parallel = nullptr; ///< Scalar engine: search every puzzle with all of this pool's threads.
+    };
+
+    inline RecordStatus toRecordStatus(SolveResult result) {
+        switch (result) {
+            case SolveResult::Solved: return RecordStatus::Solved;
+            case SolveResult::Aborted: return RecordStatus::Aborted;
+            default: return RecordStatus::Unsolvable;
+        }
+    }
+
+    /** @brief Runs a one-at-a-time engine (`SudokuSolver`, `DlxSolver`) on 81 cells. */
+    template <typename Backend>
+    RecordStatus solveRecord(Backend& backend, const char* puzzle) {
+        if (!backend.initialize(puzzle, PUZZLE_SIZE)) return RecordStatus::Invalid;
+        return toRecordStatus(backend.solve());
+    }
+
+    /**
+     * @brief Brings one input line (without its '\n') into the solver's 81-byte form.
+     *
+     * A clean 81-byte line is returned as is; anything else (CRLF, embedded blanks, ...)
+     * is compacted into `scratch`.
+     * @return The 81 cells, or nullptr if the line does not hold exactly 81 non-blank characters.
+     */
+    const char* compactRecord(const char* line, size_t len, char (&scratch)[PUZZLE_SIZE]);
+
+    /**
+     * @brief Turns well-formed records into output records with the engine selected in `SolveOptions`.
+     *
+     * Shared by the file workers and the streaming pipeline; one instance per thread. Records
+     * are numbered from the value passed to `begin`, and their output records are appended to
+     * the caller's buffer in input order. The batch engine holds back up to `BatchSolver::LANES`
+     * records until its lanes are full, so the caller calls `finish` before it writes the buffer
+     * out at the end of a run of consecutive records. With a `SolveCache`, every well-formed
+     * record is looked up by its canonical form first, and fresh verdicts are added to it.
+     */
+    class RecordSolver {
+    public:
+        RecordSolver(const RecordMarkers& markers, const SolveOptions& options, WorkerStats& stats,
+                     WorkerProgress& progress);
+
+        /**
+         * @brief Output bytes per record: OUTPUT_RECORD_SIZE, `countRecordSize` in count mode,
+         * PACKED_STATUS_RECORD_SIZE for packed output.
+         */
+        size_t recordSize() const { return recordBytes; }
+
+        /** @brief Starts a run of consecutive records; the next record is number `firstRecord`. */
+        void begin(uint64_t firstRecord) { nextRecord = firstRecord; }
+
+        /**
+         * @brief Solves (or counts) one record and appends its output record to `out`.
+         * @param puzzle The 81 cells from `compactRecord`, or nullptr for a malformed line.
+         */
+        void process(const char* puzzle, std::string& out);
+
+        /**
+         * @brief `process` for a 41-byte packed record. The scalar engine loads it with
+         * `SudokuSolver::initializePacked`; the others (and cached runs) get it unpacked to text.
+         */
+        void processPacked(const uint8_t* packed, std::string& out);
+
+        /** @brief Solves the records the batch engine is still holding and appends them to `out`. */
+        void finish(std::string& out);
+
+        /** @brief True if records that ran out of budget are waiting for `retryDeferred`. */
+        bool hasDeferred() const { return !deferred.empty(); }
+
+        /** @brief Number of records waiting for `retryDeferred`. */
+        size_t deferredCount() const { return deferred.size(); }
+
+        /**
+         * @brief Retries the aborted records collected so far with `SolveOptions::retryBudget`.
+         *
+         * `write(record, data)` receives the `recordSize()` bytes that replace the aborted
+         * record number `record`; a record that aborts again keeps its marker and is
+         * not passed on. Returns false as soon as `write` does.
+         */
+        bool retryDeferred(const std::function<bool(uint64_t record, const char* data)>& write);
+
+    private:
+        // Puzzles that ran out of budget, retried after the caller's share of the fast work.
+        struct DeferredRecord {
+            uint64_t record;
+            char puzzle[PUZZLE_SIZE];
+        };
+
+        void emit(RecordStatus status, const char* solution, const char* puzzle, std::string& out);
+
+        void formatRecord(RecordStatus status, const char* solution, const char* puzzle, char* record) const;
+
+        void solveStaged(std::string& out);
+
+        /**
+         * @brief Canonicalizes `puzzle` into `form` and looks it up in the cache. On a hit `cells`
+         * receives what `emit` needs: the solution, or the puzzle itself for other verdicts.
+         */
+        bool lookupCached(const char* puzzle, CanonicalForm& form, RecordStatus& status, char* cells);
+
+        template <typename Backend>
+        void solveOne(Backend& backend, const char* puzzle, std::string& out);
+
+        void countOne(const char* puzzle, std::string& out);
+
+        const RecordMarkers& markers;
+        const SolveOptions& options;
+        WorkerStats& stats;
+        WorkerProgress& progress;
+        const size_t recordBytes;
+        char invalidVerdict;
+        char abortedVerdict;
+        uint64_t nextRecord = 0;
+        std::vector<DeferredRecord> deferred;
+
+        SudokuSolver solver;
+        BatchSolver batchSolver;
+        DlxSolver dlxSolver;
+
+        // Cache lookups of the one-at-a-time engines.
+        CanonicalForm form;
+        char cachedCells[PUZZLE_SIZE];
+
+        // The scalar engine with `SolveOptions::parallel`: `solver` searched by the whole pool,
+        // behind the same interface as the one-at-a-time engines.
+        struct SplitSearch {
+            ParallelSearch* search = nullptr;
+            SudokuSolver* solver = nullptr;
+            SearchBudget budget;
+            char solution[PUZZLE_SIZE];
+
+            bool initialize(const char* puzzle, size_t len) { return solver->initialize(puzzle, len); }
+            void setBudget(const SearchBudget& limits) { budget = limits; }
+            SolveResult solve();
+            const char* getSolution() const { return solution; }
+#if SUDOKU_STATS
+            const SearchStats& searchStats() const { return solver->searchStats(); }
+#endif
+        };
+        SplitSearch splitSearch;
+
+        // Batch engine: up to LANES consecutive records are staged, then solved together and
+        // emitted in their original order. Records already known to be invalid, and records the
+        // cache answered, take no lane.
+        enum class Staged : uint8_t { Lane, Malformed, Cached };
+        static constexpr size_t LANES = BatchSolver::LANES;
+        char staged[LANES][PUZZLE_SIZE];
+        const char* stagedPuzzles[LANES];
+        Staged stagedKind[LANES];
+        CanonicalForm laneForms[LANES];
+        RecordStatus stagedStatus[LANES];
+        char stagedCells[LANES][PUZZLE_SIZE];
+        size_t stagedCount = 0;
+        size_t lanesUsed = 0;
+    };
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef SUDOKU_APP_RUN_JOURNAL_HPP
+#define SUDOKU_APP_RUN_JOURNAL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "output_file.hpp"
+
+namespace SudokuApp {
+
+    /** @brief FNV-1a over `len` bytes, continuing from `hash`; used to fingerprint a run. */
+    uint64_t fingerprintBytes(uint64_t hash, const void* data, size_t len);
+
+    /** Seed of `fingerprintBytes` (the FNV-1a offset basis). */
+    constexpr uint64_t FINGERPRINT_SEED = 0xCBF29CE484222325ull;
+
+    /**
+     * @brief Checkpoint journal of a file-mode run: which chunks are durably in the output.
+     *
+     * The journal is a small header (the run's fingerprint and chunk count) followed by one
+     * fixed-size entry per finished chunk, in completion order. Workers hand finished chunks
+     * to `complete`, which only queues them; a committer thread makes them durable in groups:
+     * it syncs the output file first and then appends and syncs the entries, so an entry never
+     * describes records that could still be lost. A crash loses at most the chunks of the
+     * last `COMMIT_INTERVAL`, and the solving threads never wait for the disk.
+     *
+     * A later run with the same fingerprint reads the entries back (a torn last entry is
+     * dropped) and skips those chunks.
+     */
+    class RunJournal {
+    public:
+        /** Least time between two group commits. */
+        static constexpr unsigned COMMIT_INTERVAL_MS = 100;
+
+        RunJournal() = default;
+        ~RunJournal();
+
+        RunJournal(const RunJournal&) = delete;
+        RunJournal& operator=(const RunJournal&) = delete;
+
+        /**
+         * @brief Opens the journal at `path` for a run of `chunkCount` chunks.
+         *
+         * With `resume` an existing journal with the same `fingerprint` and chunk count is read
+         * back and appended to; otherwise (or if it belongs to another run) it is started over.
+         * @return false if the journal cannot be read or written (an error is printed to stderr).
+         */
+        bool open(const std::string& path, uint64_t fingerprint, size_t chunkCount, bool resume = true);
+
+        /** @brief Chunks a previous run finished, as read by `open`. */
+        size_t completedCount() const { return completedChunks; }
+
+        /** @brief True if a previous run finished chunk `chunk`. */
+        bool completed(size_t chunk) const { return done[chunk] != 0; }
+
+        /** @brief Starts the committer thread; `output` is synced before every group of entries. */
+        void start(const PositionalOutputFile& output);
+
+        /** @brief Queues chunk `chunk` as written; it is durable after the next group commit. */
+        void complete(size_t chunk);
+
+        /**
+         * @brief Commits what is still queued and stops the committer.
+         * @return false if any sync or journal write failed.
+         */
+        bool finish();
+
+        /** @brief Closes and deletes the journal (after a completed run). */
+        void remove();
+
+    private:
+        struct Entry {
+            uint64_t chunk;
+            uint64_t check;     ///< Derived from the fingerprint and `chunk`; catches torn writes.
+        };
+
+        Entry makeEntry(uint64_t chunk) const;
+        bool append(const std::vector<Entry>& entries);
+        bool sync();
+        void commitLoop();
+        void close();
+
+        std::string path;
+        uint64_t fingerprint = 0;
+        std::vector<uint8_t> done;
+        size_t completedChunks = 0;
+#if defined(_WIN32)
+        void* handle_ = nullptr;
+#else
+        int fd_ = -1;
+#endif
+
+        const PositionalOutputFile* output = nullptr;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<size_t> pending;
+        bool stopping = false;
+        bool failed = false;
+        std::thread committer;
+    };
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef SUDOKU_APP_RUN_SOLVER_HPP
+#define SUDOKU_APP_RUN_SOLVER_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "cpu_topology.hpp"
+#include "progress.hpp"
+#include "record_solver.hpp"
+#include "run_stats.hpp"
+#include "solve_cache.hpp"
+#include "stream_pipeline.hpp"
+
+namespace SudokuApp {
+
+    /** Default chunk size: small enough that a cluster of hard puzzles spreads over several workers. */
+    constexpr uint64_t DEFAULT_CHUNK_BYTES = 64 * 1024;
+
+    /** @brief A whole file-to-file (or stream-to-stream) run, as configured on the command line. */
+    struct RunConfig {
+        std::string inputFilename = "input.txt";   ///< "-" is stdin.
+        std::string outputFilename = "output.txt"; ///< "-" is stdout.
+        unsigned threads = 0;                      ///< 0 = pick from the hardware.
+        bool pinThreads = false;                   ///< Bind each worker to its CPU (see `CpuTopology::placement`).
+        bool useMappedReader = true;
+        bool streamMode = false;                   ///< Forced on when either name is "-".
+        bool splitSearch = false;                  ///< One puzzle at a time, searched by all threads (`ParallelSearch`).
+        bool verify = false;                       ///< Check `puzzle,solution` records instead of solving (`runSolver`).
+        bool checkpoint = false;                   ///< File mode: journal finished chunks and resume from `<output>.journal`.
+        uint64_t chunkBytes = DEFAULT_CHUNK_BYTES;
+        unsigned gridSize = 0;                     ///< Cells per side (4, 9, 16, 25); 0 = detect from the input (9 for stdin).
+        bool useCache = false;                     ///< Answer repeated and equivalent puzzles from a `SolveCache`.
+        std::string cachePath;                     ///< Non-empty: the cache is loaded from and saved back to this file.
+        size_t cacheEntries = DEFAULT_CACHE_ENTRIES;
+        ProgressOptions progress;                  ///< Live progress on stderr or in a status file.
+        RecordMarkers markers;
+        SolveOptions solve;
+        StreamOptions stream;
+    };
+
+    enum class RunResult : uint8_t {
+        Completed,  ///< Every record was written.
+        EmptyInput, ///< The input file is empty; nothing was written.
+        Failed      ///< An error was printed; an incomplete output file is removed.
+    };
+
+    /**
+     * @brief Worker count for `requested` threads, capped at `maxUseful`. 0 = auto: one per
+     * physical core of `topology`, or without topology information all hardware threads up
+     * to 4 and half of them above that. Auto-detection is reported on `log`.
+     */
+    unsigned determineThreadCount(unsigned requested, uint64_t maxUseful, const CpuTopology& topology, std::ostream& log);
+
+    /**
+     * @brief Solves every record of `config.inputFilename` into `config.outputFilename`.
+     *
+     * File mode partitions the input, counts the records of every chunk and lets the workers
+     * write their chunks in place; stream mode runs `runStreamPipeline`. Both run on one
+     * `ThreadPool` placed by `CpuTopology::placement`; pinned file-mode runs on several NUMA
+     * nodes give each node its own share of the chunks. With `splitSearch` the records are
+     * read and written in order instead, and each puzzle's search is split across the pool
+     * (`ParallelSearch`). With `useCache` the workers share one `SolveCache`, loaded from
+     * `cachePath` before the run and saved after it. Grids other than 9x9 run in file mode
+     * only, through `gridSolverWorker`. Each worker counts into its own `ProgressCounters`
+     * slot, which a `ProgressReporter` reads when `config.progress` asks for live reports.
+     * Progress messages go to `log` (the caller passes stderr when stdout carries the
+     * records). `stats` is filled in for the run report either way.
+     *
+     * With `verify` the input holds `puzzle,solution` records instead, checked by
+     * `verifierWorker` on the same partitioning; the output lists the failing records as
+     * `line,reason`, and `stats.solved` counts the valid ones.
+     */
+    RunResult runSolver(const RunConfig& config, RunStats& stats, std::ostream& log);
+
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef SUDOKU_APP_RUN_STATS_HPP
+#define SUDOKU_APP_RUN_STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "chunk_scheduler.hpp"
+#include "latency_histogram.hpp"
+#include "search_stats.hpp"
+
+namespace SudokuApp {
+
+    /**
+     * @brief Per-worker instrumentation, filled in by the worker and merged after it is joined.
+     * Only SUDOKU_STATS builds write to it.
+     */
+    struct WorkerStats {
+        LatencyHistogram solveLatency;  ///< Nanoseconds per puzzle.
+        SearchStats search;
+        double solveSeconds = 0.0;      ///< Time inside the solver.
+        double writeSeconds = 0.0;      ///< Time inside output writes.
+
+        void merge(const WorkerStats& other) {
+            solveLatency.merge(other.solveLatency);
+            search += other.search;
+            solveSeconds += other.solveSeconds;
+            writeSeconds += other.writeSeconds;
+        }
+    };
+
+    /**
+     * @brief Adds the lifetime of the timer to `seconds` (and, for puzzles, to a histogram).
+     * In builds without SUDOKU_STATS it is an empty object and compiles to nothing.
+     */
+    class StatsTimer {
+    public:
+#if SUDOKU_STATS
+        explicit StatsTimer(double& seconds, LatencyHistogram* histogram = nullptr, uint64_t puzzles = 1)
+            : seconds(seconds), histogram(histogram), puzzles(puzzles), start(std::chrono::steady_clock::now()) {}
+
+        ~StatsTimer() {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            seconds += std::chrono::duration<double>(elapsed).count();
+            if (histogram == nullptr || puzzles == 0) return;
+            // A batch of puzzles solved together is recorded as that many equal shares.
+            const uint64_t share = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / puzzles;
+            for (uint64_t i = 0; i < puzzles; ++i) histogram->record(share);
+        }
+
+    private:
+        double& seconds;
+        LatencyHistogram* histogram;
+        uint64_t puzzles;
+        std::chrono::steady_clock::time_point start;
+#else
+        explicit StatsTimer(double&, LatencyHistogram* = nullptr, uint64_t = 1) {}
+#endif
+        StatsTimer(const StatsTimer&) = delete;
+        StatsTimer& operator=(const StatsTimer&) = delete;
+    };
+
+    enum class StatsFormat : uint8_t { Text, Json };
+
+    /** @brief How the workers were laid out on the host (the report's placement line). */
+    struct PlacementSummary {
+        unsigned logicalCpus = 0;       ///< CPUs the process may run on.
+        unsigned physicalCores = 0;
+        unsigned numaNodes = 0;
+        bool topologyDetected = false;  ///< False: no sysfs topology, every CPU counted as a core.
+        bool pinRequested = false;
+        unsigned pinnedWorkers = 0;
+        bool perNodeChunks = false;     ///< The input was split into one chunk run per node.
+    };
+
+    /** @brief Solve cache figures (the report's cache line). */
+    struct CacheSummary {
+        bool enabled = false;
+        uint64_t loaded = 0;            ///< Entries read from the cache file.
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t entries = 0;           ///< Entries at the end of the run.
+    };
+
+    /** @brief Everything the final report needs. */
+    struct RunStats {
+        uint64_t records = 0;
+        uint64_t solved = 0;
+        unsigned threads = 0;
+        size_t chunks = 0;
+        double scanSeconds = 0.0;       ///< Partitioning and counting records.
+        double solveWallSeconds = 0.0;  ///< From starting the workers until all are joined.
+        double mergeSeconds = 0.0;      ///< Merging the per-worker figures.
+        WorkerStats merged;             ///< Sum over workers (SUDOKU_STATS builds only).
+        PlacementSummary placement;
+        CacheSummary cache;
+        std::vector<WorkerLoad> loads;
+    };
+
+    /** @brief Prints how busy each worker was over the solving phase, to check the load is balanced. */
+    void printLoadReport(const std::vector<WorkerLoad>& loads, size_t chunkCount, double wallSeconds, std::ostream& out);
+
+    /**
+     * @brief Prints the run report: throughput, phase timings and, in SUDOKU_STATS builds,
+     * solve-time percentiles (p50/p99/p99.9) and search counts. The text form ends with the
+     * load report.
+     */
+    void printRunStats(const RunStats& stats, StatsFormat format, std::ostream& out);
+
+}
+
+#endif
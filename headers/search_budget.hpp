@@ -0,0 +1,65 @@
+#ifndef SUDOKU_APP_SEARCH_BUDGET_HPP
+#define SUDOKU_APP_SEARCH_BUDGET_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace SudokuApp {
+
+    /** @brief Outcome of a search. */
+    enum class SolveResult : uint8_t {
+        Solved,
+        Unsolvable, ///< The search space was exhausted without a solution.
+        Aborted     ///< The search budget ran out first; the puzzle may or may not be solvable.
+    };
+
+    /** @brief Per-puzzle search limits; 0 means no limit. */
+    struct SearchBudget {
+        uint64_t maxNodes = 0;
+        uint32_t maxMillis = 0;
+        const std::atomic<bool>* cancel = nullptr;  ///< Set from another thread to stop the search (e.g. a sibling found the solution).
+
+        bool limited() const { return maxNodes != 0 || maxMillis != 0 || cancel != nullptr; }
+    };
+
+    /**
+     * @brief Counts search nodes against a `SearchBudget`.
+     *
+     * The budget is only looked at every CHECK_INTERVAL nodes, so the per-node cost is one
+     * increment and compare, and an unlimited budget never reads the clock. A cancel flag is
+     * polled at the same points, so a cancelled search stops within CHECK_INTERVAL nodes.
+     */
+    class BudgetTracker {
+    public:
+        static constexpr uint64_t CHECK_INTERVAL = 4096;
+
+        void start(const SearchBudget& budget) {
+            limits = budget;
+            nodes = 0;
+            nextCheck = budget.limited() ? CHECK_INTERVAL : UINT64_MAX;
+            if (budget.maxMillis != 0) deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget.maxMillis);
+        }
+
+        /** @brief Counts one node. @return true if the search must stop. */
+        bool step() { return ++nodes == nextCheck && exhausted(); }
+
+        uint64_t nodeCount() const { return nodes; }
+
+    private:
+        bool exhausted() {
+            nextCheck += CHECK_INTERVAL;
+            if (limits.cancel != nullptr && limits.cancel->load(std::memory_order_relaxed)) return true;
+            if (limits.maxNodes != 0 && nodes >= limits.maxNodes) return true;
+            return limits.maxMillis != 0 && std::chrono::steady_clock::now() >= deadline;
+        }
+
+        SearchBudget limits;
+        uint64_t nodes = 0;
+        uint64_t nextCheck = UINT64_MAX;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+}
+
+#endif
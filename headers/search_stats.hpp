@@ -0,0 +1,36 @@
+#ifndef SUDOKU_APP_SEARCH_STATS_HPP
+#define SUDOKU_APP_SEARCH_STATS_HPP
+
+#include <cstdint>
+
+// Opt-in instrumentation: 1 = solvers count search events and workers time every puzzle.
+// With 0 (the default) the counters are not even members, so the hot loops are unchanged.
+#ifndef SUDOKU_STATS
+#define SUDOKU_STATS 0
+#endif
+
+#if SUDOKU_STATS
+#define SUDOKU_STAT(statement) do { statement; } while (0)
+#else
+#define SUDOKU_STAT(statement) do { } while (0)
+#endif
+
+namespace SudokuApp {
+
+    /** @brief Search events of one puzzle (or a sum over many). */
+    struct SearchStats {
+        uint64_t nodes = 0;         ///< Search nodes entered (each runs propagation).
+        uint64_t guesses = 0;       ///< Branching placements.
+        uint64_t backtracks = 0;    ///< Guesses undone after their subtree failed.
+
+        SearchStats& operator+=(const SearchStats& other) {
+            nodes += other.nodes;
+            guesses += other.guesses;
+            backtracks += other.backtracks;
+            return *this;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SUDOKU_APP_SOLUTION_VERIFIER_HPP
+#define SUDOKU_APP_SOLUTION_VERIFIER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace SudokuApp {
+
+    /** @brief Verdict on one (puzzle, solution) pair, in the order the checks are made. */
+    enum class VerifyResult : uint8_t {
+        Valid,          ///< The solution is a complete valid grid that keeps every clue.
+        Malformed,      ///< The record does not hold 81 puzzle cells and 81 solution cells.
+        BadCell,        ///< A solution cell is not '1'-'9'.
+        ClueMismatch,   ///< A clue of the puzzle is changed in the solution.
+        RowConflict,    ///< A digit repeats in a row.
+        ColumnConflict, ///< A digit repeats in a column.
+        BoxConflict     ///< A digit repeats in a box.
+    };
+
+    /** @brief A record that did not verify. */
+    struct VerifyFailure {
+        uint64_t record;        ///< 0-based record (line) number.
+        VerifyResult result;
+    };
+
+    /** @brief "valid", "malformed", "bad-cell", "clue", "row", "column" or "box". */
+    const char* verifyResultName(VerifyResult result);
+
+    /**
+     * @brief Finds the puzzle and the solution in a verification record (without its '\n').
+     *
+     * A record is the 81 puzzle cells and the 81 solution cells, usually `puzzle,solution`;
+     * blanks and one separating ',' are dropped, as whitespace is in solver input. A clean
+     * 163-byte record is used in place; anything else is compacted into `scratch`.
+     * @return false if the record does not hold exactly 162 cells.
+     */
+    bool splitVerifyRecord(const char* record, size_t len, char (&scratch)[162], const char*& puzzle, const char*& solution);
+
+    /** @brief Checks one pair with the scalar kernel. Puzzle cells other than '1'-'9' are empty. */
+    VerifyResult verifySolution(const char* puzzle, const char* solution);
+
+    /**
+     * @brief Checks up to `LANES` (puzzle, solution) pairs at a time with branch-free SIMD.
+     *
+     * The clue and cell checks run per record on 16-byte vectors. The grids are then
+     * transposed so that each vector holds one cell of all `LANES` solutions, and a unit is
+     * valid if no two of its cells are equal, which is one compare per cell pair for all
+     * records at once (810 pairs: rows, columns, and the box pairs not already in a row or
+     * column). Nothing depends on the data, so throughput is the same for valid and broken
+     * grids. Without SSE2 every pair goes through `verifySolution`.
+     */
+    class SolutionVerifier {
+    public:
+        static constexpr size_t LANES = 16;
+
+        SolutionVerifier();
+
+        /** @brief Copies the 81-cell `puzzle` and `solution` into lane `lane` for the next `check`. */
+        void load(size_t lane, const char* puzzle, const char* solution) {
+            std::memcpy(clues[lane], puzzle, CELLS);
+            std::memcpy(grids[lane], solution, CELLS);
+        }
+
+        /** @brief Checks lanes 0 to `count` - 1 into `results`. */
+        void check(size_t count, VerifyResult* results);
+
+        /** @brief `load` and `check` for `count` (at most `LANES`) pairs. */
+        void verify(const char* const* puzzles, const char* const* solutions, size_t count, VerifyResult* results);
+
+        /** @brief "sse2" or "scalar". */
+        static const char* kernelName();
+
+    private:
+        static constexpr size_t CELLS = 81;
+
+        alignas(16) uint8_t grids[LANES][96];   ///< The solutions, padded to 6 vectors.
+        alignas(16) uint8_t clues[LANES][96];   ///< The puzzles, padded likewise.
+        alignas(16) uint8_t cells[96][LANES];   ///< `grids` transposed: cell c of every lane.
+    };
+
+}
+
+#endif
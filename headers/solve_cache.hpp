@@ -0,0 +1,88 @@
+#ifndef SUDOKU_APP_SOLVE_CACHE_HPP
+#define SUDOKU_APP_SOLVE_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "canonical_form.hpp"
+#include "packed_format.hpp"
+#include "record_solver.hpp"
+
+namespace SudokuApp {
+
+    /** Default bound on cached puzzles (~100 bytes each). */
+    constexpr size_t DEFAULT_CACHE_ENTRIES = size_t(1) << 20;
+
+    /**
+     * @brief Verdicts of solved puzzles, keyed on their canonical form and shared by all workers.
+     *
+     * The table is split into shards by the top bits of the canonical hash, each behind its own
+     * reader/writer lock, so lookups from different workers rarely meet. Entries hold the
+     * canonical puzzle and solution packed (packed_format.hpp); a lookup compares the whole
+     * puzzle, so hash collisions are misses, not wrong answers. Only final verdicts are kept
+     * (solved, unsolvable): aborted puzzles depend on the budget, invalid ones are rejected
+     * before any search anyway. Once full, the cache keeps what it has and stops inserting.
+     */
+    class SolveCache {
+    public:
+        explicit SolveCache(size_t maxEntries = DEFAULT_CACHE_ENTRIES);
+
+        SolveCache(const SolveCache&) = delete;
+        SolveCache& operator=(const SolveCache&) = delete;
+
+        /**
+         * @brief Looks up the puzzle `form` was computed from.
+         * @param solution Receives the solution in the puzzle's own coordinates if the verdict is `Solved`.
+         */
+        bool lookup(const CanonicalForm& form, RecordStatus& status, char* solution);
+
+        /** @brief Remembers a verdict; `solution` (puzzle coordinates) is read for `Solved` only. */
+        void insert(const CanonicalForm& form, RecordStatus status, const char* solution);
+
+        /**
+         * @brief Adds the entries of a cache file written by `save`. A missing file is not an error.
+         * @return false (with an error on stderr) if the file is unreadable, not a cache file, or
+         * has an entry that fails its checksum or does not fit its verdict.
+         */
+        bool load(const std::string& filename);
+
+        /** @brief Writes every entry to `filename`, replacing it. */
+        bool save(const std::string& filename) const;
+
+        size_t size() const;
+        uint64_t lookups() const;
+        uint64_t hits() const;
+
+    private:
+        static constexpr size_t SHARD_BITS = 6;
+        static constexpr size_t SHARDS = size_t(1) << SHARD_BITS;
+
+        struct Entry {
+            uint8_t puzzle[PACKED_CELLS_SIZE];
+            RecordStatus status;
+            uint8_t solution[PACKED_CELLS_SIZE];
+        };
+
+        struct alignas(64) Shard {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<uint64_t, Entry> entries;
+            std::atomic<uint64_t> lookups{0};
+            std::atomic<uint64_t> hits{0};
+        };
+
+        Shard& shardFor(uint64_t hash) const { return shards[hash >> (64 - SHARD_BITS)]; }
+
+        bool add(uint64_t hash, const Entry& entry);
+
+        std::unique_ptr<Shard[]> shards;
+        size_t maxPerShard;
+    };
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef SUDOKU_APP_SOLVER_POOL_HPP
+#define SUDOKU_APP_SOLVER_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "record_solver.hpp"
+#include "thread_pool.hpp"
+
+namespace SudokuApp {
+
+    /**
+     * @brief Persistent worker threads for solving in-memory batches (the library entry point).
+     *
+     * The threads (a `ThreadPool`) and their solvers are created once, with the pool, and
+     * reused by every `solveBatch` call; a call hands out blocks of puzzles from an atomic
+     * cursor. Nothing is allocated per call or per puzzle. Batches of at most one block run
+     * on the calling thread alone.
+     *
+     * Calls from several threads are safe; they run one after the other.
+     */
+    class SolverPool {
+    public:
+        /** @param threads Worker threads; 0 = `std::thread::hardware_concurrency()`. */
+        explicit SolverPool(unsigned threads = 0);
+        ~SolverPool();
+
+        SolverPool(const SolverPool&) = delete;
+        SolverPool& operator=(const SolverPool&) = delete;
+
+        /** @brief Threads that work on a batch. */
+        unsigned threadCount() const { return static_cast<unsigned>(states.size()); }
+
+        /**
+         * @brief Solves `count` puzzles of 81 bytes each, stored back to back in `puzzles`.
+         *
+         * Solution `i` goes to `solutions + 81 * i` when `statuses[i]` is `Solved`; otherwise
+         * those 81 bytes are a copy of the puzzle. `options.engine` and `options.budget` apply;
+         * count mode and retries are file-mode features and are ignored here.
+         * `statuses` may be null.
+         */
+        void solveBatch(const char* puzzles, size_t count, char* solutions, RecordStatus* statuses, const SolveOptions& options);
+
+        /** @brief A process-wide pool with one thread per hardware thread, created on first use. */
+        static SolverPool& shared();
+
+    private:
+        struct ThreadState;
+
+        struct Batch {
+            const char* puzzles;
+            size_t count;
+            char* solutions;
+            RecordStatus* statuses;
+            const SolveOptions* options;
+        };
+
+        void work(ThreadState& state);
+
+        std::mutex callMutex;                   ///< Serializes `solveBatch` callers.
+        Batch batch{};
+        alignas(64) std::atomic<size_t> cursor{0};
+
+        std::vector<std::unique_ptr<ThreadState>> states;   ///< One per worker; small batches use [0] on the caller.
+        ThreadPool threads;
+    };
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SUDOKU_APP_STREAM_PIPELINE_HPP
+#define SUDOKU_APP_STREAM_PIPELINE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "chunk_scheduler.hpp"
+#include "record_solver.hpp"
+#include "run_stats.hpp"
+#include "thread_pool.hpp"
+
+namespace SudokuApp {
+
+    /** @brief Sizing of the streaming pipeline; memory use is about `slots * slotRecords * 164` bytes. */
+    struct StreamOptions {
+        size_t slotRecords = 1024;  ///< Records per slot (the unit a worker claims).
+        size_t slots = 0;           ///< Ring capacity in slots; 0 = four per worker.
+        int gzipLevel = -1;         ///< 0-9: the workers gzip their slots (`GzipBlockCompressor`); -1 = plain text.
+        bool rejectOtherGrids = false;  ///< Fail if the first non-blank line is not a 9x9 grid (`gridSizeForCells`).
+    };
+
+    /**
+     * @brief Solves every line of `input` and writes the results to `output` in input order,
+     * without seeking either stream (pipes, terminals, sockets).
+     *
+     * A reader thread cuts the input into slots of fixed-size 81-byte records, the threads of
+     * `workers` solve slots in any order and a writer thread writes them out in sequence. The
+     * stages share one bounded ring of slots; a slot moves reader -> worker -> writer -> reader
+     * through an atomic sequence stamp, so there are no locks and at most `slots` slots are
+     * alive. When the writer falls behind (slow consumer) the reader stops reading, which
+     * pushes back on the producer.
+     *
+     * Gzip input is recognized by its magic bytes and decompressed by the reader (`GzipReader`,
+     * with up to one inflate thread per worker for BGZF members). With `gzipLevel` each worker
+     * compresses its own slots into independent gzip members, which the writer appends.
+     *
+     * With `rejectOtherGrids` a first line of 16, 256 or 625 cells stops the run with an error
+     * instead of being marked invalid: stdin cannot be checked for its grid size beforehand.
+     *
+     * Output records are the same as in file mode. With `options.retryAborted` the aborted
+     * records of a slot are retried as soon as the slot's first pass is done, before it is
+     * written. Worker i counts its records into `progress[i]` (one slot per pool thread).
+     *
+     * @return false if reading or writing failed; the error is printed to std::cerr.
+     */
+    bool runStreamPipeline(std::FILE* input,
+                           std::FILE* output,
+                           ThreadPool& workers,
+                           const StreamOptions& streamOptions,
+                           const RecordMarkers& markers,
+                           const SolveOptions& options,
+                           std::vector<WorkerLoad>& loads,
+                           std::vector<WorkerStats>& stats,
+                           ProgressCounters& progress);
+
+}
+
+#endif
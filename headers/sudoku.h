@@ -0,0 +1,97 @@
+/*
+ * libsudoku C API.
+ *
+ * Stable, C-compatible entry points for solving puzzles in-process. A puzzle is 81 bytes,
+ * row by row: '1'-'9' for givens, '0' or '.' for empty cells, no separators. Batches are
+ * stored back to back (puzzle i at offset 81 * i).
+ *
+ * Solving runs on a persistent thread pool inside the library: either the process-wide
+ * default pool (sudoku_solve_batch) or one created with sudoku_pool_create. No memory is
+ * allocated per call or per puzzle.
+ */
+#ifndef SUDOKU_H
+#define SUDOKU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(SUDOKU_SHARED)
+    #if defined(SUDOKU_BUILDING_LIBRARY)
+        #define SUDOKU_API __declspec(dllexport)
+    #else
+        #define SUDOKU_API __declspec(dllimport)
+    #endif
+#elif defined(__GNUC__)
+    #define SUDOKU_API __attribute__((visibility("default")))
+#else
+    #define SUDOKU_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bumped on incompatible changes; compare with sudoku_api_version() at runtime. */
+#define SUDOKU_API_VERSION 1
+
+/** Outcome per puzzle (one byte each). */
+typedef uint8_t sudoku_status;
+enum {
+    SUDOKU_SOLVED = 0,      /* The solution was written. */
+    SUDOKU_INVALID = 1,     /* Conflicting givens. */
+    SUDOKU_UNSOLVABLE = 2,  /* Well-formed, but there is no solution. */
+    SUDOKU_ABORTED = 3      /* The search budget ran out first. */
+};
+
+enum {
+    SUDOKU_ENGINE_SCALAR = 0,   /* Bitmask backtracking, one puzzle at a time (default). */
+    SUDOKU_ENGINE_BATCH = 1,    /* 16 puzzles at a time with SIMD propagation. */
+    SUDOKU_ENGINE_DLX = 2       /* Dancing links (exact cover). */
+};
+
+/* Return codes. */
+enum {
+    SUDOKU_OK = 0,
+    SUDOKU_ERROR_ARGUMENT = -1, /* Null pointer or unknown engine / options size. */
+    SUDOKU_ERROR_INTERNAL = -2  /* Out of memory or a thread could not be started. */
+};
+
+typedef struct sudoku_options {
+    uint32_t size;          /* sizeof(sudoku_options); set by sudoku_options_init. */
+    uint32_t engine;        /* SUDOKU_ENGINE_*. */
+    uint64_t max_nodes;     /* Per-puzzle search node budget, 0 = unlimited. */
+    uint32_t max_ms;        /* Per-puzzle time budget in milliseconds, 0 = unlimited. */
+} sudoku_options;
+
+typedef struct sudoku_pool sudoku_pool;
+
+/** Returns SUDOKU_API_VERSION of the library that is actually loaded. */
+SUDOKU_API int sudoku_api_version(void);
+
+/** Fills `options` with the defaults (scalar engine, no budget). */
+SUDOKU_API void sudoku_options_init(sudoku_options* options);
+
+/**
+ * Solves `count` puzzles from `puzzles` into `solutions` (both 81 * count bytes; they may be
+ * the same buffer). For puzzles that are not solved, the output holds a copy of the puzzle.
+ * `statuses` (count bytes) may be NULL, `options` may be NULL for the defaults.
+ * Uses the process-wide pool, which has one thread per hardware thread.
+ */
+SUDOKU_API int sudoku_solve_batch(const char* puzzles, size_t count, char* solutions,
+                                  sudoku_status* statuses, const sudoku_options* options);
+
+/** Creates a pool with `threads` worker threads (0 = hardware threads); NULL on failure. */
+SUDOKU_API sudoku_pool* sudoku_pool_create(unsigned threads);
+
+/** Stops and joins the pool's threads. No call on the pool may be running. */
+SUDOKU_API void sudoku_pool_destroy(sudoku_pool* pool);
+
+/** sudoku_solve_batch on a given pool. Concurrent calls on one pool run one after the other. */
+SUDOKU_API int sudoku_pool_solve_batch(sudoku_pool* pool, const char* puzzles, size_t count, char* solutions,
+                                       sudoku_status* statuses, const sudoku_options* options);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,68 +3,190 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <type_traits>
+
+#include "search_budget.hpp"
+#include "search_stats.hpp"
+
+// Selects the search loop at build time: 1 = explicit-stack iterative search (default),
+// 0 = the recursive solveInternal. Both explore nodes in the same order.
+#ifndef SUDOKU_ITERATIVE_SEARCH
+#define SUDOKU_ITERATIVE_SEARCH 1
+#endif
 
 namespace SudokuApp {
 
     /**
      * @brief Solves Sudoku puzzles using a backtracking algorithm with bitmasks and MRV heuristic.
      *
-     * This class maintains the state of a single Sudoku grid and provides methods
-     * to initialize it with a puzzle string, solve it, and retrieve the solution.
-     * It is designed to be efficient for solving standard 9x9 Sudoku puzzles.
+     * Every search node first applies constraint propagation (naked and hidden singles)
+     * until a fixpoint; only then does it branch on the MRV cell. Every placement is
+     * recorded on a trail so a failed branch is undone by popping back to its mark.
+     *
+     * The candidate mask of every empty cell is kept up to date incrementally: `place` and
+     * `remove` only touch the peers of the changed cell (20 on a 9x9 grid). Empty cells are also
+     * bucketed by candidate count (one bit set over the cells per count), so naked singles, dead
+     * ends and the MRV cell are all found with a couple of word tests instead of a scan.
+     *
+     * The grid size is a template parameter: boxes of `BoxRows` x `BoxCols` cells make an
+     * N x N grid with N = BoxRows * BoxCols. The unit, peer and cell tables are generated at
+     * compile time for each size, and the masks are `uint16_t` up to 15 digits, `uint32_t`
+     * above. Digits 1-9 are written '1'-'9', 10 and up 'A', 'B', ... (lower case accepted).
+     * The sizes the library uses are instantiated once in sudoku_solver.cpp; `SudokuSolver`
+     * is the classic 9x9 one.
+     *
      * Note: This class is intended for single-threaded use per instance. For multi-threading,
      * use separate instances (e.g., via `thread_local`).
      */
-    class SudokuSolver {
+    template <unsigned BoxRows, unsigned BoxCols>
+    class BasicSudokuSolver {
     public:
+        static constexpr unsigned DIGITS = BoxRows * BoxCols;     ///< N: digits, and cells per unit.
+        static constexpr unsigned CELLS = DIGITS * DIGITS;
+        static constexpr unsigned PEERS = 2 * (DIGITS - 1) + (BoxRows - 1) * (BoxCols - 1);
+
+        static_assert(DIGITS >= 4 && DIGITS <= 25, "grids from 4x4 to 25x25 are supported");
+
+        /** Bit d is set if digit d is present / possible; bit 0 is unused. */
+        using Mask = typename std::conditional<(DIGITS < 16), uint16_t, uint32_t>::type;
+        /** Holds any cell index (and trail mark). */
+        using CellIndex = typename std::conditional<(CELLS <= 256), uint8_t, uint16_t>::type;
+
+        /** @brief The character for digit `value` (1..N). */
+        static constexpr char symbol(unsigned value) {
+            if constexpr (DIGITS <= 9) return static_cast<char>('0' + value);
+            else return static_cast<char>(value <= 9 ? '0' + value : 'A' + (value - 10));
+        }
+
         /**
          * @brief Initializes the solver state with a puzzle string.
          *
          * Resets internal state and populates the grid and bitmasks based on the input.
-         * The input string must represent an 81-character grid, using '1'-'9' for filled cells
-         * and '0' or '.' (or any other character) for empty cells.
+         * The input string must hold N*N characters (81 for 9x9): digit symbols for filled cells
+         * and '0' or '.' (or any other character) for empty cells. A digit symbol above N
+         * (e.g. '7' on a 4x4 grid) makes the puzzle invalid.
          * Basic validation (no immediate conflicts) is performed during initialization.
          *
          * @param puzzle_data A pointer to the character array containing the puzzle string.
-         * @param len The length of the puzzle string (must be 81).
+         * @param len The length of the puzzle string (must be `CELLS`).
          * @return true if the input string has the correct length and the initial puzzle
          *         state has no obvious rule violations (duplicate numbers in row/col/box).
          * @return false otherwise.
          */
         bool initialize(const char* puzzle_data, size_t len);
 
+        /**
+         * @brief Same as `initialize`, from a 41-byte packed record (see packed_format.hpp).
+         *
+         * The nibbles are unpacked with SIMD and go straight into the bitmasks, without the
+         * per-character parsing of the text form. Packed records are 9x9 only; other sizes
+         * return false.
+         *
+         * @return false if the record is malformed or has conflicting clues.
+         */
+        bool initializePacked(const uint8_t* packed);
+
         /**
          * @brief Attempts to solve the initialized puzzle using backtracking.
          *
          * Assumes `initialize` has been called successfully. Modifies the internal grid state.
          *
-         * @return true if a valid solution is found.
-         * @return false if the puzzle is unsolvable from the initialized state.
+         * @return `Solved` if a valid solution is found, `Unsolvable` if the puzzle has none,
+         *         `Aborted` if the budget set with `setBudget` ran out first.
+         */
+        SolveResult solve();
+
+        /**
+         * @brief Limits every later `solve` / `countSolutions` call to `budget` nodes / time.
+         * The default budget is unlimited.
+         */
+        void setBudget(const SearchBudget& budget) { this->budget = budget; }
+
+        /** @brief True if the last `solve` or `countSolutions` stopped because of the budget. */
+        bool budgetExhausted() const { return aborted; }
+
+        /** @brief Search nodes of the last `solve` / `countSolutions` call (also without SUDOKU_STATS). */
+        uint64_t nodesVisited() const { return tracker.nodeCount(); }
+
+        /**
+         * @brief Runs the propagation the search starts every node with and returns the cell it
+         * would branch on. With `cellCandidates` and `assume` this steps the search by hand,
+         * to split it into subproblems (ParallelSearch); `solve` or `countSolutions` on a copy
+         * then searches the rest of that subtree.
+         * @return The branching cell, or -1 if the puzzle is decided here: `complete()` if the
+         *         grid is filled (`getSolution` holds it), a contradiction otherwise.
+         */
+        int branchCell();
+
+        /** @brief True if no cell is empty. */
+        bool complete() const { return emptyCount == 0; }
+
+        /** @brief The candidate digits of an empty cell (bit d for digit d). */
+        Mask cellCandidates(int cell) const { return cand[cell]; }
+
+        /** @brief Places candidate `num` in `cell` as a search guess (see `branchCell`). */
+        void assume(int cell, int num);
+
+#if SUDOKU_STATS
+        /** @brief Search events of the last `solve` / `countSolutions` call (SUDOKU_STATS builds only). */
+        const SearchStats& searchStats() const { return stats; }
+#endif
+
+        /**
+         * @brief Counts the solutions of the initialized puzzle, stopping at `limit`.
+         *
+         * Runs the same search as `solve` but keeps going after a solution until `limit`
+         * solutions have been seen (`limit` = 2 is the uniqueness check). Always uses the
+         * iterative search, whatever `SUDOKU_ITERATIVE_SEARCH` selects for `solve`.
+         * If the result is non-zero, `getSolution` returns a solution afterwards.
+         *
+         * @return The number of solutions, capped at `limit` (0 if unsolvable). If
+         *         `budgetExhausted()` afterwards, it is only a lower bound.
          */
-        bool solve();
+        uint64_t countSolutions(uint64_t limit);
 
         /**
          * @brief Gets a pointer to the current state of the Sudoku grid.
          *
-         * Returns a pointer to the internal 81-character buffer. If `solve()` returned true,
-         * this buffer contains the solution. If `solve()` returned false or was not called,
+         * Returns a pointer to the internal `CELLS`-character buffer. If `solve()` returned `Solved`,
+         * this buffer contains the solution. Otherwise, or if `solve()` was not called,
          * it contains the grid in its current state after initialization or partial solving attempt.
-         * The pointer remains valid only for the lifetime of the SudokuSolver object.
+         * The pointer remains valid only for the lifetime of the solver object.
          *
-         * @return const char* Pointer to the 81-character grid buffer.
+         * @return const char* Pointer to the grid buffer.
          */
         const char* getSolution() const;
 
     private:
-        alignas(64) uint16_t rows[9] = {0};
-        alignas(64) uint16_t cols[9] = {0};
-        alignas(64) uint16_t boxes[9] = {0};
-        char grid[81];
-        uint8_t emptyCells[81];
-        uint8_t position[81];
+        // Benchmarks in bench/ reach the internals through this.
+        friend struct SolverBenchAccess;
+
+        static constexpr unsigned WORDS = (CELLS + 63) / 64;   ///< 64-bit words per cell set.
+
+        alignas(64) Mask rows[DIGITS] = {0};
+        alignas(64) Mask cols[DIGITS] = {0};
+        alignas(64) Mask boxes[DIGITS] = {0};
+        alignas(64) Mask cand[CELLS];           ///< Candidates of each empty cell, 0 for filled cells.
+        uint64_t countBuckets[DIGITS + 1][WORDS];   ///< Empty cells with exactly N candidates, as a cell set.
+        char grid[CELLS];
+        char firstSolution[CELLS];              ///< Kept by countSolutions while it searches for more.
         int emptyCount = 0;
+        CellIndex trail[CELLS];
+        int trailSize = 0;
+
+        SearchBudget budget;
+        BudgetTracker tracker;
+        bool aborted = false;
+#if SUDOKU_STATS
+        SearchStats stats;
+#endif
+
+        // Explicit search stack for solveIterative, one frame per guess (at most CELLS deep).
+        CellIndex stackCell[CELLS];
+        CellIndex stackMark[CELLS];
+        Mask stackRemaining[CELLS];
 
-        inline bool canPlace(int cell, int num) const;
+        bool canPlace(int cell, int num) const;
 
         void place(int cell, int num);
 
@@ -72,31 +194,28 @@ namespace SudokuApp {
 
         int findMRV() const;
 
-        bool solveInternal();
-    };
+        inline Mask candidates(int cell) const;
 
+        inline void setCandidates(int cell, Mask possible);
 
-    inline bool SudokuSolver::canPlace(int cell, int num) const {
-        struct CellInfo { uint8_t row, col, box; };
-        static constexpr CellInfo preCell_internal_lookup[81] = {
-            {0,0,0}, {0,1,0}, {0,2,0}, {0,3,1}, {0,4,1}, {0,5,1}, {0,6,2}, {0,7,2}, {0,8,2},
-            {1,0,0}, {1,1,0}, {1,2,0}, {1,3,1}, {1,4,1}, {1,5,1}, {1,6,2}, {1,7,2}, {1,8,2},
-            {2,0,0}, {2,1,0}, {2,2,0}, {2,3,1}, {2,4,1}, {2,5,1}, {2,6,2}, {2,7,2}, {2,8,2},
-            {3,0,3}, {3,1,3}, {3,2,3}, {3,3,4}, {3,4,4}, {3,5,4}, {3,6,5}, {3,7,5}, {3,8,5},
-            {4,0,3}, {4,1,3}, {4,2,3}, {4,3,4}, {4,4,4}, {4,5,4}, {4,6,5}, {4,7,5}, {4,8,5},
-            {5,0,3}, {5,1,3}, {5,2,3}, {5,3,4}, {5,4,4}, {5,5,4}, {5,6,5}, {5,7,5}, {5,8,5},
-            {6,0,6}, {6,1,6}, {6,2,6}, {6,3,7}, {6,4,7}, {6,5,7}, {6,6,8}, {6,7,8}, {6,8,8},
-            {7,0,6}, {7,1,6}, {7,2,6}, {7,3,7}, {7,4,7}, {7,5,7}, {7,6,8}, {7,7,8}, {7,8,8},
-            {8,0,6}, {8,1,6}, {8,2,6}, {8,3,7}, {8,4,7}, {8,5,7}, {8,6,8}, {8,7,8}, {8,8,8}
-        };
+        bool propagate();
 
+        void undoTo(int mark);
+
+        bool solveInternal();
+
+        bool solveIterative();
+
+        uint64_t searchIterative(uint64_t limit);
+    };
 
-        const uint16_t mask = 1 << num;
-        if (cell < 0 || cell >= 81) return false;
-        const auto& info = preCell_internal_lookup[cell];
-        return !((rows[info.row] | cols[info.col] | boxes[info.box]) & mask);
-    }
+    extern template class BasicSudokuSolver<2, 2>;
+    extern template class BasicSudokuSolver<3, 3>;
+    extern template class BasicSudokuSolver<4, 4>;
+    extern template class BasicSudokuSolver<5, 5>;
 
+    /** The classic 9x9 solver, used by every engine and the packed format. */
+    using SudokuSolver = BasicSudokuSolver<3, 3>;
 
 }
 
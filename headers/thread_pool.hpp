@@ -0,0 +1,80 @@
+#ifndef SUDOKU_APP_THREAD_POOL_HPP
+#define SUDOKU_APP_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cpu_topology.hpp"
+
+namespace SudokuApp {
+
+    /**
+     * @brief A fixed set of worker threads that run one task at a time, all of them together.
+     *
+     * The threads are started once and reused for every `run` (the record count pass, the
+     * solve pass, later batches), so their stacks, caches and pinning survive between phases.
+     * Each worker can be bound to a logical CPU; the CPU's NUMA node is kept so callers can
+     * hand it work whose memory should live on that node.
+     */
+    class ThreadPool {
+    public:
+        /** @brief Unpinned pool of `threads` workers (at least one). */
+        explicit ThreadPool(unsigned threads);
+
+        /**
+         * @brief One worker per entry of `placement`; with `pin` each is bound to its CPU.
+         * Pinning failures are not fatal; `pinned(i)` reports them.
+         */
+        ThreadPool(const std::vector<LogicalCpu>& placement, bool pin);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+        /** @brief The CPU worker `i` was placed on (meaningful when the pool was given a placement). */
+        const LogicalCpu& cpu(unsigned i) const { return workers[i].cpu; }
+
+        /** @brief True if worker `i` is bound to `cpu(i)`. */
+        bool pinned(unsigned i) const { return workers[i].pinned; }
+
+        /**
+         * @brief Runs `task(i)` on every worker `i` and returns when all have finished.
+         * An exception thrown by a task is rethrown here (the first one, if several).
+         * Not reentrant: one `run` at a time per pool.
+         */
+        void run(const std::function<void(unsigned)>& task);
+
+    private:
+        struct Worker {
+            LogicalCpu cpu;
+            bool pin = false;
+            bool pinned = false;
+            std::thread thread;
+        };
+
+        void start();
+
+        void workerLoop(unsigned index);
+
+        std::vector<Worker> workers;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        const std::function<void(unsigned)>* task = nullptr;
+        uint64_t generation = 0;        ///< Bumped for every `run`.
+        unsigned busy = 0;
+        bool stopping = false;
+        std::exception_ptr failure;
+    };
+
+}
+
+#endif
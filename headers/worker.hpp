@@ -4,17 +4,106 @@
 #include <string>
 #include <cstddef>
 #include <atomic>
+#include <vector>
+
+#include "chunk_scheduler.hpp"
+#include "input_partition.hpp"
+#include "mapped_file.hpp"
+#include "output_file.hpp"
+#include "record_solver.hpp"
+#include "run_journal.hpp"
+#include "run_stats.hpp"
+#include "search_budget.hpp"
+#include "solution_verifier.hpp"
 
 namespace SudokuApp {
 
+    /**
+     * @brief Claims chunks from `scheduler` until none are left, solving and writing each in place.
+     *
+     * Chunks of `domain` (the worker's NUMA node, see `ChunkScheduler`) are claimed first.
+     * If `mappedInput` is non-null the records are read zero-copy from the mapping;
+     * otherwise the worker opens `inputFilename` and seeks to each chunk. A non-zero
+     * `packedRecordSize` means the mapping is a packed file (packed_format.hpp) and the chunks
+     * are ranges of its records.
+     * The i-th record of a chunk is written to `output` at
+     * `(chunk.firstRecord + i) * OUTPUT_RECORD_SIZE`; records that cannot be solved are
+     * written as the matching entry of `markers` so every record keeps its slot. Packed
+     * output (`options.output`) uses PACKED_STATUS_RECORD_SIZE-byte records instead.
+     * `options.engine` selects the solver backend.
+     * If `options.countLimit` is non-zero the worker counts solutions instead (scalar engine
+     * only) and writes one `countRecordSize(countLimit)`-byte verdict per record; invalid and
+     * aborted records get the first character of their marker repeated ('X' / '?' if that
+     * character is a digit).
+     * Puzzles that exceed `options.budget` are written with the aborted marker; with
+     * `options.retryAborted` the worker retries them once it has no chunks left to claim,
+     * using `options.retryBudget`, and overwrites the marker in place (solve mode only).
+     * With a `journal` (may be null), chunks it has from an earlier run are skipped, and every
+     * chunk written without an error is passed to `RunJournal::complete`; a chunk with retried
+     * records only once the retry pass has rewritten them.
+     * Time spent on chunks is accumulated into `load` and the records handled into the worker's
+     * own `progress` slot; SUDOKU_STATS builds also time every puzzle and write into `stats`.
+     */
     void solverWorker(
         size_t workerId,
         const std::string& inputFilename,
-        const std::string& tempFilePrefix,
-        size_t startLine,
-        size_t endLine,
-        std::atomic<size_t>& solvedCounter,
-        std::atomic<size_t>& processedCounter,
+        const MappedFile* mappedInput,
+        size_t packedRecordSize,
+        const PositionalOutputFile& output,
+        RunJournal* journal,
+        const std::vector<InputChunk>& chunks,
+        ChunkScheduler& scheduler,
+        size_t domain,
+        const RecordMarkers& markers,
+        const SolveOptions& options,
+        WorkerLoad& load,
+        WorkerStats& stats,
+        WorkerProgress& progress,
+        std::atomic<bool>& errorFlag);
+
+    /**
+     * @brief Claims chunks like `solverWorker`, but checks `puzzle,solution` records
+     * (`splitVerifyRecord`) with a `SolutionVerifier` instead of solving them; nothing is written.
+     *
+     * Each record that does not verify is appended to `failures` with its record number (in
+     * claim order, not sorted). Valid records count as solved in `progress`.
+     */
+    void verifierWorker(
+        size_t workerId,
+        const std::string& inputFilename,
+        const MappedFile* mappedInput,
+        const std::vector<InputChunk>& chunks,
+        ChunkScheduler& scheduler,
+        size_t domain,
+        WorkerLoad& load,
+        WorkerProgress& progress,
+        std::vector<VerifyFailure>& failures,
+        std::atomic<bool>& errorFlag);
+
+    /**
+     * @brief `solverWorker` for grids of `gridSize` x `gridSize` cells (4, 16 or 25; 9 works too).
+     *
+     * Reads mapped text records only and always solves them with the scalar solver of that
+     * size (`BasicSudokuSolver`). Output records are the N*N cells plus '\n'; failed records get
+     * the first character of their marker repeated. With `options.retryAborted` an aborted
+     * puzzle is retried right away with `options.retryBudget` instead of after the chunks.
+     * Solution counting and packed output are not available here. It runs the same chunk loop
+     * as `solverWorker` (claiming, batching, journaling), with that solver in place of `RecordSolver`.
+     */
+    void gridSolverWorker(
+        unsigned gridSize,
+        size_t workerId,
+        const MappedFile& mappedInput,
+        const PositionalOutputFile& output,
+        RunJournal* journal,
+        const std::vector<InputChunk>& chunks,
+        ChunkScheduler& scheduler,
+        size_t domain,
+        const RecordMarkers& markers,
+        const SolveOptions& options,
+        WorkerLoad& load,
+        WorkerStats& stats,
+        WorkerProgress& progress,
         std::atomic<bool>& errorFlag);
 
 }
@@ -0,0 +1,135 @@
+#include "batch_solver.hpp"
+#include "cpu_features.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SUDOKU_BATCH_SSE2 1
+#else
+    #define SUDOKU_BATCH_SSE2 0
+#endif
+
+namespace SudokuApp {
+
+namespace {
+
+#if SUDOKU_BATCH_SSE2
+    // 16 lanes as two SSE2 registers; SSE2 is part of the x86-64 baseline, so no dispatch needed.
+    struct Sse2Vec {
+        struct Reg { __m128i lo, hi; };
+        static Reg load(const uint16_t* p) {
+            return { _mm_load_si128(reinterpret_cast<const __m128i*>(p)), _mm_load_si128(reinterpret_cast<const __m128i*>(p + 8)) };
+        }
+        static void store(uint16_t* p, Reg a) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(p), a.lo);
+            _mm_store_si128(reinterpret_cast<__m128i*>(p + 8), a.hi);
+        }
+        static Reg set1(uint16_t v) { const __m128i x = _mm_set1_epi16(static_cast<short>(v)); return { x, x }; }
+        static Reg zero() { return { _mm_setzero_si128(), _mm_setzero_si128() }; }
+        static Reg bor(Reg a, Reg b) { return { _mm_or_si128(a.lo, b.lo), _mm_or_si128(a.hi, b.hi) }; }
+        static Reg band(Reg a, Reg b) { return { _mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi) }; }
+        static Reg andnot(Reg a, Reg b) { return { _mm_andnot_si128(a.lo, b.lo), _mm_andnot_si128(a.hi, b.hi) }; }
+        static Reg sub(Reg a, Reg b) { return { _mm_sub_epi16(a.lo, b.lo), _mm_sub_epi16(a.hi, b.hi) }; }
+        static Reg cmpeq(Reg a, Reg b) { return { _mm_cmpeq_epi16(a.lo, b.lo), _mm_cmpeq_epi16(a.hi, b.hi) }; }
+        // No ptest in SSE2: a lane is non-zero unless every byte compares equal to zero.
+        static bool any(Reg a) {
+            const __m128i x = _mm_or_si128(a.lo, a.hi);
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xFFFF;
+        }
+    };
+
+    void propagateSse2(BatchState& state) { BatchDetail::propagate<Sse2Vec>(state); }
+#endif
+
+    // Portable fallback: the same kernel on a plain array, left to the compiler to vectorize.
+    struct ScalarVec {
+        struct Reg { uint16_t v[BATCH_LANES]; };
+        template <typename F>
+        static Reg map(Reg a, Reg b, F f) { Reg r; for (size_t i = 0; i < BATCH_LANES; ++i) r.v[i] = static_cast<uint16_t>(f(a.v[i], b.v[i])); return r; }
+        static Reg load(const uint16_t* p) { Reg r; memcpy(r.v, p, sizeof(r.v)); return r; }
+        static void store(uint16_t* p, Reg a) { memcpy(p, a.v, sizeof(a.v)); }
+        static Reg set1(uint16_t x) { Reg r; for (auto& e : r.v) e = x; return r; }
+        static Reg zero() { return set1(0); }
+        static Reg bor(Reg a, Reg b) { return map(a, b, [](uint16_t x, uint16_t y) { return x | y; }); }
+        static Reg band(Reg a, Reg b) { return map(a, b, [](uint16_t x, uint16_t y) { return x & y; }); }
+        static Reg andnot(Reg a, Reg b) { return map(a, b, [](uint16_t x, uint16_t y) { return ~x & y; }); }
+        static Reg sub(Reg a, Reg b) { return map(a, b, [](uint16_t x, uint16_t y) { return x - y; }); }
+        static Reg cmpeq(Reg a, Reg b) { return map(a, b, [](uint16_t x, uint16_t y) { return x == y ? 0xFFFF : 0; }); }
+        static bool any(Reg a) { uint16_t acc = 0; for (auto e : a.v) acc |= e; return acc != 0; }
+    };
+
+    void propagateScalar(BatchState& state) { BatchDetail::propagate<ScalarVec>(state); }
+
+    int digitOf(uint16_t bit) {
+        int d = 0;
+        while (bit > 1) { bit >>= 1; ++d; }
+        return d;
+    }
+
+}
+
+BatchSolver::BatchSolver() {
+    kernel = nullptr;
+    name = "scalar";
+    if (cpuHasAvx2()) {
+        kernel = batchPropagateAvx2();
+        if (kernel) name = "avx2";
+    }
+#if SUDOKU_BATCH_SSE2
+    if (!kernel) { kernel = propagateSse2; name = "sse2"; }
+#endif
+    if (!kernel) kernel = propagateScalar;
+}
+
+void BatchSolver::solve(const char* const puzzles[], size_t count) {
+    if (count > LANES) count = LANES;
+    memset(&state, 0, sizeof(state));
+    SUDOKU_STAT(stats = SearchStats());
+
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        status[lane] = LaneStatus::Unsolvable;
+        if (lane >= count) { state.dead[lane] = 0xFFFF; continue; }
+        const char* puzzle = puzzles[lane];
+        for (int i = 0; i < 81; ++i) {
+            const char c = puzzle[i];
+            if (c < '1' || c > '9') continue;
+            const uint16_t bit = static_cast<uint16_t>(1 << (c - '0'));
+            const auto& u = BatchDetail::tables.cell[i];
+            if ((state.rows[u.row][lane] | state.cols[u.col][lane] | state.boxes[u.box][lane]) & bit) {
+                status[lane] = LaneStatus::Invalid;
+                state.dead[lane] = 0xFFFF;
+                break;
+            }
+            state.cells[i][lane] = bit;
+            state.rows[u.row][lane] |= bit;
+            state.cols[u.col][lane] |= bit;
+            state.boxes[u.box][lane] |= bit;
+        }
+    }
+
+    kernel(state);
+
+    for (size_t lane = 0; lane < count; ++lane) {
+        // A contradiction reached by propagation alone means the puzzle has no solution.
+        if (state.dead[lane]) continue;
+        bool complete = true;
+        for (int i = 0; i < 81; ++i) {
+            const uint16_t bit = state.cells[i][lane];
+            grids[lane][i] = bit ? static_cast<char>('0' + digitOf(bit)) : '0';
+            complete &= bit != 0;
+        }
+        if (!complete) {
+            // Stalled: search from where the kernel stopped instead of from the givens.
+            if (!fallback.initialize(grids[lane], 81)) continue;
+            const SolveResult result = fallback.solve();
+            SUDOKU_STAT(stats += fallback.searchStats());
+            if (result == SolveResult::Aborted) status[lane] = LaneStatus::Aborted;
+            if (result != SolveResult::Solved) continue;
+            memcpy(grids[lane], fallback.getSolution(), 81);
+        }
+        status[lane] = LaneStatus::Solved;
+    }
+}
+
+}
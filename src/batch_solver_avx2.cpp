@@ -0,0 +1,39 @@
+// Built with AVX2 code generation (see CMakeLists.txt); only reached after cpuHasAvx2().
+#include "batch_kernel.hpp"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && defined(_M_X64))
+    #include <immintrin.h>
+    #define SUDOKU_BATCH_AVX2 1
+#else
+    #define SUDOKU_BATCH_AVX2 0
+#endif
+
+namespace SudokuApp {
+
+#if SUDOKU_BATCH_AVX2
+namespace {
+
+    struct Avx2Vec {
+        using Reg = __m256i;
+        static Reg load(const uint16_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+        static void store(uint16_t* p, Reg a) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), a); }
+        static Reg set1(uint16_t v) { return _mm256_set1_epi16(static_cast<short>(v)); }
+        static Reg zero() { return _mm256_setzero_si256(); }
+        static Reg bor(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+        static Reg band(Reg a, Reg b) { return _mm256_and_si256(a, b); }
+        static Reg andnot(Reg a, Reg b) { return _mm256_andnot_si256(a, b); }
+        static Reg sub(Reg a, Reg b) { return _mm256_sub_epi16(a, b); }
+        static Reg cmpeq(Reg a, Reg b) { return _mm256_cmpeq_epi16(a, b); }
+        static bool any(Reg a) { return !_mm256_testz_si256(a, a); }
+    };
+
+    void propagateAvx2(BatchState& state) { BatchDetail::propagate<Avx2Vec>(state); }
+
+}
+
+BatchPropagateFn batchPropagateAvx2() { return propagateAvx2; }
+#else
+BatchPropagateFn batchPropagateAvx2() { return nullptr; }
+#endif
+
+}
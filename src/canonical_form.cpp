@@ -0,0 +1,185 @@
+#include "canonical_form.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace SudokuApp {
+
+namespace {
+
+    // Full grid comparisons per puzzle. Most puzzles need a handful; patterns where many
+    // orders tie stop here instead of trying all of them.
+    constexpr size_t MAX_CANDIDATES = 1024;
+
+    // Band order times the row order inside each band: at most 6^4 line orders.
+    constexpr size_t MAX_LINE_ORDERS = 1296;
+
+    constexpr uint8_t PERMUTATIONS[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+    using LineOrder = std::array<uint8_t, 9>;
+    using BandSignature = std::array<uint32_t, 3>;
+
+    /** @brief The permutations p with `items[p[i]]` in descending order; ties give several. */
+    template <typename T>
+    size_t sortingPermutations(const T (&items)[3], uint8_t (&result)[6]) {
+        T sorted[3] = {items[0], items[1], items[2]};
+        std::sort(sorted, sorted + 3, [](const T& a, const T& b) { return b < a; });
+        size_t count = 0;
+        for (uint8_t p = 0; p < 6; ++p) {
+            const uint8_t* perm = PERMUTATIONS[p];
+            if (items[perm[0]] == sorted[0] && items[perm[1]] == sorted[1] && items[perm[2]] == sorted[2]) result[count++] = p;
+        }
+        return count;
+    }
+
+    /** @brief The orders of the nine rows (or columns) that sort bands and lines by their keys. */
+    struct LineOrders {
+        std::array<BandSignature, 3> signature;   ///< Sorted band signatures; the same for every equivalent puzzle.
+        std::array<LineOrder, MAX_LINE_ORDERS> orders;
+        size_t count = 0;
+
+        explicit LineOrders(const uint32_t (&keys)[9]) {
+            uint8_t linePerms[3][6];
+            size_t linePermCount[3];
+            BandSignature bands[3];
+            for (size_t b = 0; b < 3; ++b) {
+                const uint32_t lines[3] = {keys[3 * b], keys[3 * b + 1], keys[3 * b + 2]};
+                linePermCount[b] = sortingPermutations(lines, linePerms[b]);
+                const uint8_t* first = PERMUTATIONS[linePerms[b][0]];
+                bands[b] = {lines[first[0]], lines[first[1]], lines[first[2]]};
+            }
+            uint8_t bandPerms[6];
+            const size_t bandPermCount = sortingPermutations(bands, bandPerms);
+            for (size_t i = 0; i < 3; ++i) signature[i] = bands[PERMUTATIONS[bandPerms[0]][i]];
+
+            for (size_t bp = 0; bp < bandPermCount; ++bp) {
+                const uint8_t* band = PERMUTATIONS[bandPerms[bp]];
+                for (size_t a = 0; a < linePermCount[band[0]]; ++a) {
+                    for (size_t b = 0; b < linePermCount[band[1]]; ++b) {
+                        for (size_t c = 0; c < linePermCount[band[2]]; ++c) {
+                            const uint8_t* within[3] = {PERMUTATIONS[linePerms[band[0]][a]], PERMUTATIONS[linePerms[band[1]][b]],
+                                                        PERMUTATIONS[linePerms[band[2]][c]]};
+                            LineOrder& order = orders[count++];
+                            for (size_t i = 0; i < 9; ++i) order[i] = static_cast<uint8_t>(3 * band[i / 3] + within[i / 3][i % 3]);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+}
+
+void CanonicalForm::toCanonical(const char* grid, char* canonical) const {
+    for (size_t i = 0; i < CELLS; ++i) {
+        const char c = grid[source[i]];
+        canonical[i] = c >= '1' && c <= '9' ? toLabel[c - '0'] : '0';
+    }
+}
+
+void CanonicalForm::fromCanonical(const char* canonical, char* grid) const {
+    for (size_t i = 0; i < CELLS; ++i) {
+        const char c = canonical[i];
+        grid[source[i]] = c >= '1' && c <= '9' ? fromLabel[c - '0'] : '0';
+    }
+}
+
+uint64_t canonicalHash(const char* cells) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < CanonicalForm::CELLS; ++i) hash = (hash ^ static_cast<uint8_t>(cells[i])) * 1099511628211ull;
+    return hash;
+}
+
+void canonicalize(const char* puzzle, CanonicalForm& form) {
+    constexpr size_t CELLS = CanonicalForm::CELLS;
+    uint8_t grid[CELLS];
+    uint32_t rowCount[9] = {};
+    uint32_t colCount[9] = {};
+    for (size_t i = 0; i < CELLS; ++i) {
+        grid[i] = puzzle[i] >= '1' && puzzle[i] <= '9' ? static_cast<uint8_t>(puzzle[i] - '0') : 0;
+        if (grid[i] != 0) { rowCount[i / 9]++; colCount[i % 9]++; }
+    }
+    // A line's key is its clue count, refined by the clue counts of the lines crossing it at
+    // its clues. Both survive every symmetry, so equivalent puzzles sort their lines alike.
+    uint32_t rowKeys[9];
+    uint32_t colKeys[9];
+    for (size_t k = 0; k < 9; ++k) {
+        rowKeys[k] = rowCount[k] << 12;
+        colKeys[k] = colCount[k] << 12;
+    }
+    for (size_t i = 0; i < CELLS; ++i) {
+        if (grid[i] == 0) continue;
+        rowKeys[i / 9] += colCount[i % 9] * colCount[i % 9];
+        colKeys[i % 9] += rowCount[i / 9] * rowCount[i / 9];
+    }
+    const LineOrders rows(rowKeys);
+    const LineOrders cols(colKeys);
+
+    char best[CELLS];
+    char candidate[CELLS];
+    bool haveBest = false;
+    bool bestTransposed = false;
+    const LineOrder* bestRows = nullptr;
+    const LineOrder* bestCols = nullptr;
+    size_t budget = MAX_CANDIDATES;
+
+    // Transposed, the columns play the rows. Orientations whose row signature is smaller lose anyway.
+    const auto tryOrders = [&](const LineOrders& outer, const LineOrders& inner, bool transposed) {
+        for (size_t r = 0; r < outer.count; ++r) {
+            for (size_t c = 0; c < inner.count && budget != 0; ++c, --budget) {
+                const LineOrder& R = outer.orders[r];
+                const LineOrder& C = inner.orders[c];
+                char label[10] = {};
+                char next = '1';
+                bool smaller = !haveBest;
+                bool larger = false;
+                for (size_t i = 0; i < CELLS; ++i) {
+                    const uint8_t d = grid[transposed ? C[i % 9] * 9 + R[i / 9] : R[i / 9] * 9 + C[i % 9]];
+                    char v = '0';
+                    if (d != 0) {
+                        if (label[d] == 0) label[d] = next++;
+                        v = label[d];
+                    }
+                    candidate[i] = v;
+                    if (!smaller) {
+                        if (v > best[i]) { larger = true; break; }
+                        smaller = v < best[i];
+                    }
+                }
+                if (larger || !smaller) continue;
+                std::memcpy(best, candidate, CELLS);
+                haveBest = true;
+                bestTransposed = transposed;
+                bestRows = &R;
+                bestCols = &C;
+            }
+        }
+    };
+    if (!(rows.signature < cols.signature)) tryOrders(rows, cols, false);
+    if (!(cols.signature < rows.signature)) tryOrders(cols, rows, true);
+
+    std::memcpy(form.cells, best, CELLS);
+    const LineOrder& R = *bestRows;
+    const LineOrder& C = *bestCols;
+    for (size_t i = 0; i < CELLS; ++i) {
+        form.source[i] = static_cast<uint8_t>(bestTransposed ? C[i % 9] * 9 + R[i / 9] : R[i / 9] * 9 + C[i % 9]);
+    }
+    // Digits label in order of first appearance; digits missing from the puzzle take the
+    // remaining labels in increasing order.
+    std::memset(form.toLabel, 0, sizeof(form.toLabel));
+    char next = '1';
+    for (size_t i = 0; i < CELLS; ++i) {
+        const uint8_t d = grid[form.source[i]];
+        if (d != 0 && form.toLabel[d] == 0) form.toLabel[d] = next++;
+    }
+    for (uint8_t d = 1; d <= 9; ++d) {
+        if (form.toLabel[d] == 0) form.toLabel[d] = next++;
+    }
+    form.toLabel[0] = '0';
+    form.fromLabel[0] = '0';
+    for (uint8_t d = 1; d <= 9; ++d) form.fromLabel[form.toLabel[d] - '0'] = static_cast<char>('0' + d);
+    form.hash = canonicalHash(form.cells);
+}
+
+}
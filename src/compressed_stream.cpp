@@ -0,0 +1,410 @@
+#include "compressed_stream.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <vector>
+
+#if SUDOKU_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace SudokuApp {
+
+bool startsWithGzipMagic(const std::string& filename) {
+    char magic[2] = {};
+    std::ifstream in(filename, std::ios::binary);
+    in.read(magic, sizeof(magic));
+    return hasGzipMagic(magic, static_cast<size_t>(in.gcount()));
+}
+
+#if SUDOKU_HAVE_ZLIB
+
+namespace {
+
+    /** Input bytes per member: what `bgzip` uses, so that even stored data fits the 16-bit size. */
+    constexpr size_t BLOCK_INPUT = 0xFF00;
+    constexpr size_t MAX_BLOCK = 0x10000;
+    /** Fixed header (10) + XLEN (2) + the `BC` subfield (6). */
+    constexpr size_t BLOCK_HEADER = 18;
+    /** CRC32 + ISIZE. */
+    constexpr size_t BLOCK_TRAILER = 8;
+    /** Members read ahead per inflate thread; each inflates to at most BLOCK_INPUT bytes. */
+    constexpr size_t BLOCKS_PER_THREAD = 16;
+    constexpr size_t RAW_READ = 1 << 20;
+
+    void putLE16(unsigned char* p, uint32_t v) {
+        p[0] = static_cast<unsigned char>(v);
+        p[1] = static_cast<unsigned char>(v >> 8);
+    }
+
+    void putLE32(unsigned char* p, uint32_t v) {
+        putLE16(p, v & 0xFFFF);
+        putLE16(p + 2, v >> 16);
+    }
+
+    uint32_t getLE16(const unsigned char* p) { return uint32_t(p[0]) | uint32_t(p[1]) << 8; }
+
+    uint32_t getLE32(const unsigned char* p) { return getLE16(p) | getLE16(p + 2) << 16; }
+
+    // gzip member header with FEXTRA and one `BC` subfield holding the member size - 1.
+    void writeBlockHeader(unsigned char* p, size_t blockSize) {
+        static const unsigned char FIXED[16] = {0x1F, 0x8B, 8, 4, 0, 0, 0, 0, 0, 0xFF, 6, 0, 'B', 'C', 2, 0};
+        std::memcpy(p, FIXED, sizeof(FIXED));
+        putLE16(p + 16, static_cast<uint32_t>(blockSize - 1));
+    }
+
+    /**
+     * @brief Size of the BGZF member whose first `len` (>= 12) bytes are `p`, from its `BC`
+     * subfield; 0 if it is not one. Needs the whole extra field: `len >= 12 + XLEN`.
+     */
+    size_t blockSize(const unsigned char* p, size_t len) {
+        if (p[0] != 0x1F || p[1] != 0x8B || p[2] != 8 || !(p[3] & 4)) return 0;
+        const size_t extraLen = getLE16(p + 10);
+        if (len < 12 + extraLen) return 0;
+        for (size_t i = 12; i + 4 <= 12 + extraLen;) {
+            const size_t fieldLen = getLE16(p + i + 2);
+            if (p[i] == 'B' && p[i + 1] == 'C' && fieldLen == 2 && i + 6 <= 12 + extraLen) return getLE16(p + i + 4) + 1;
+            i += 4 + fieldLen;
+        }
+        return 0;
+    }
+
+}
+
+bool gzipSupported() {
+    return true;
+}
+
+struct GzipBlockCompressor::State {
+    z_stream stream{};
+    int level = DEFAULT_GZIP_LEVEL;
+    bool ready = false;
+};
+
+GzipBlockCompressor::GzipBlockCompressor(int level) : state(new State) {
+    state->level = std::max(0, std::min(9, level));
+    // Raw deflate: the gzip framing is written by hand to carry the member size.
+    state->ready = deflateInit2(&state->stream, state->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+GzipBlockCompressor::~GzipBlockCompressor() {
+    if (state->ready) deflateEnd(&state->stream);
+}
+
+bool GzipBlockCompressor::compress(const char* data, size_t len, std::string& out) {
+    if (!state->ready) return false;
+    z_stream& z = state->stream;
+    for (size_t done = 0; done < len;) {
+        const size_t input = std::min(BLOCK_INPUT, len - done);
+        const size_t start = out.size();
+        out.resize(start + MAX_BLOCK);
+        unsigned char* block = reinterpret_cast<unsigned char*>(&out[start]);
+
+        deflateReset(&z);
+        z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + done));
+        z.avail_in = static_cast<uInt>(input);
+        z.next_out = block + BLOCK_HEADER;
+        z.avail_out = static_cast<uInt>(MAX_BLOCK - BLOCK_HEADER - BLOCK_TRAILER);
+        int rc = deflate(&z, Z_FINISH);
+        if (rc != Z_STREAM_END) {
+            // Did not shrink enough to fit (random bytes): store it, which always fits.
+            deflateReset(&z);
+            deflateParams(&z, 0, Z_DEFAULT_STRATEGY);
+            z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + done));
+            z.avail_in = static_cast<uInt>(input);
+            z.next_out = block + BLOCK_HEADER;
+            z.avail_out = static_cast<uInt>(MAX_BLOCK - BLOCK_HEADER - BLOCK_TRAILER);
+            rc = deflate(&z, Z_FINISH);
+            const size_t stored = z.total_out;
+            deflateReset(&z);
+            deflateParams(&z, state->level, Z_DEFAULT_STRATEGY);
+            if (rc != Z_STREAM_END) return false;
+            z.total_out = stored;
+        }
+        const size_t size = BLOCK_HEADER + z.total_out + BLOCK_TRAILER;
+        writeBlockHeader(block, size);
+        const uLong crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data + done), static_cast<uInt>(input));
+        putLE32(block + size - BLOCK_TRAILER, static_cast<uint32_t>(crc));
+        putLE32(block + size - 4, static_cast<uint32_t>(input));
+        out.resize(start + size);
+        done += input;
+    }
+    return true;
+}
+
+void GzipBlockCompressor::appendEndMember(std::string& out) {
+    // An empty member: header, an empty final stored block (03 00), CRC 0, ISIZE 0.
+    unsigned char block[BLOCK_HEADER + 2 + BLOCK_TRAILER] = {};
+    writeBlockHeader(block, sizeof(block));
+    block[BLOCK_HEADER] = 3;
+    out.append(reinterpret_cast<const char*>(block), sizeof(block));
+}
+
+struct GzipReader::State {
+    std::FILE* file = nullptr;
+    unsigned threads = 1;
+    bool quiet = false;         ///< Print no errors or warnings.
+    std::string prefix;         ///< Bytes handed to the constructor, read before `file`.
+    size_t prefixPos = 0;
+
+    // Parallel phase: batches of whole members, inflated by `threads` threads, one batch ahead.
+    struct Batch {
+        std::vector<std::string> members;
+        std::vector<std::string> plain;
+        std::string rest;       ///< Start of a member without a `BC` size: the sequential phase takes over.
+        bool end = false;
+        bool ok = true;
+    };
+    bool parallel = true;
+    std::unique_ptr<ThreadPool> inflaters;  ///< Started once; every batch is inflated on them.
+    std::future<Batch> ahead;
+    std::vector<std::string> ready;
+    size_t readyIndex = 0;
+    size_t readyOffset = 0;
+
+    // Sequential phase.
+    z_stream stream{};
+    bool inflating = false;
+    bool inMember = false;
+    bool finished = false;
+    std::string input;
+    size_t inputPos = 0;
+
+    size_t readRaw(char* buffer, size_t size) {
+        size_t got = 0;
+        if (prefixPos < prefix.size()) {
+            got = std::min(size, prefix.size() - prefixPos);
+            std::memcpy(buffer, prefix.data() + prefixPos, got);
+            prefixPos += got;
+        }
+        if (got < size) got += std::fread(buffer + got, 1, size - got, file);
+        return got;
+    }
+
+    Batch readBatch() {
+        Batch batch;
+        const size_t limit = BLOCKS_PER_THREAD * threads;
+        unsigned char header[12 + 0xFFFF];
+        while (batch.members.size() < limit) {
+            size_t got = readRaw(reinterpret_cast<char*>(header), 12);
+            if (got == 0) {
+                batch.end = true;
+                break;
+            }
+            size_t size = 0;
+            if (got == 12 && hasGzipMagic(reinterpret_cast<char*>(header), got) && (header[3] & 4)) {
+                const size_t extraLen = getLE16(header + 10);
+                got += readRaw(reinterpret_cast<char*>(header) + 12, extraLen);
+                if (got == 12 + extraLen) size = blockSize(header, got);
+            }
+            if (size < got + BLOCK_TRAILER) {
+                batch.rest.assign(reinterpret_cast<char*>(header), got);
+                break;
+            }
+            std::string member(reinterpret_cast<char*>(header), got);
+            member.resize(size);
+            if (readRaw(&member[got], size - got) != size - got) {
+                if (!quiet) std::cerr << "Error: The gzip input ends inside a member." << std::endl;
+                batch.ok = false;
+                return batch;
+            }
+            batch.members.push_back(std::move(member));
+        }
+
+        batch.plain.resize(batch.members.size());
+        const size_t count = batch.members.size();
+        const size_t workers = inflaters->size();
+        std::vector<char> failed(workers, 0);
+        auto inflateRange = [&](unsigned w) {
+            z_stream z{};
+            if (inflateInit2(&z, -15) != Z_OK) { failed[w] = 1; return; }
+            for (size_t i = count * w / workers; i < count * (w + 1) / workers; ++i) {
+                const std::string& member = batch.members[i];
+                const unsigned char* bytes = reinterpret_cast<const unsigned char*>(member.data());
+                const size_t dataStart = 12 + getLE16(bytes + 10);
+                const uint32_t plainSize = getLE32(bytes + member.size() - 4);
+                // A BGZF member never holds more than 64 KB of text: a larger ISIZE is corrupt.
+                if (plainSize > MAX_BLOCK) {
+                    failed[w] = 1;
+                    break;
+                }
+                std::string& plain = batch.plain[i];
+                plain.resize(plainSize);
+                inflateReset(&z);
+                z.next_in = const_cast<Bytef*>(bytes + dataStart);
+                z.avail_in = static_cast<uInt>(member.size() - dataStart - BLOCK_TRAILER);
+                z.next_out = reinterpret_cast<Bytef*>(&plain[0]);
+                z.avail_out = plainSize;
+                // One zero-length output is still a valid call: `plain` may be empty.
+                unsigned char spare;
+                if (plainSize == 0) { z.next_out = &spare; z.avail_out = 1; }
+                if (inflate(&z, Z_FINISH) != Z_STREAM_END || z.total_out != plainSize
+                    || crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(plain.data()), plainSize) != getLE32(bytes + member.size() - 8)) {
+                    failed[w] = 1;
+                    break;
+                }
+            }
+            inflateEnd(&z);
+        };
+        if (count != 0) {
+            try {
+                inflaters->run(inflateRange);
+            } catch (const std::exception&) {
+                failed[0] = 1;
+            }
+        }
+        if (std::find(failed.begin(), failed.end(), 1) != failed.end()) {
+            if (!quiet) std::cerr << "Error: Corrupt gzip member in the input." << std::endl;
+            batch.ok = false;
+        }
+        batch.members.clear();
+        return batch;
+    }
+
+    void readAhead() {
+        ahead = std::async(std::launch::async, [this] { return readBatch(); });
+    }
+
+    /** @brief Makes `need` bytes available at `inputPos` if the input has them. */
+    bool fill(size_t need) {
+        if (input.size() - inputPos >= need) return true;
+        input.erase(0, inputPos);
+        inputPos = 0;
+        const size_t have = input.size();
+        input.resize(have + RAW_READ);
+        input.resize(have + readRaw(&input[have], RAW_READ));
+        return input.size() >= need;
+    }
+
+    long long inflateSome(char* buffer, size_t size) {
+        if (!inflating) {
+            if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+                if (!quiet) std::cerr << "Error: Cannot start the gzip decoder." << std::endl;
+                return -1;
+            }
+            inflating = true;
+        }
+        while (!finished) {
+            if (!inMember) {
+                // Between members: another member, the end, or trailing bytes.
+                if (!fill(2)) {
+                    if (input.size() > inputPos && !quiet) std::cerr << "Warning: Ignoring trailing data after the gzip stream." << std::endl;
+                    finished = true;
+                    break;
+                }
+                if (!hasGzipMagic(input.data() + inputPos, 2)) {
+                    if (!quiet) std::cerr << "Warning: Ignoring trailing data after the gzip stream." << std::endl;
+                    finished = true;
+                    break;
+                }
+                inflateReset(&stream);
+                inMember = true;
+            }
+            if (!fill(1)) {
+                if (!quiet) std::cerr << "Error: The gzip input ends inside a member." << std::endl;
+                return -1;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(&input[inputPos]);
+            stream.avail_in = static_cast<uInt>(input.size() - inputPos);
+            stream.next_out = reinterpret_cast<Bytef*>(buffer);
+            stream.avail_out = static_cast<uInt>(std::min<size_t>(size, 1u << 30));
+            const int rc = inflate(&stream, Z_NO_FLUSH);
+            inputPos = input.size() - stream.avail_in;
+            const size_t produced = std::min<size_t>(size, 1u << 30) - stream.avail_out;
+            if (rc == Z_STREAM_END) inMember = false;
+            else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                if (!quiet) std::cerr << "Error: Corrupt gzip input (" << (stream.msg != nullptr ? stream.msg : "inflate failed") << ")." << std::endl;
+                return -1;
+            }
+            if (produced > 0) return static_cast<long long>(produced);
+        }
+        return 0;
+    }
+};
+
+GzipReader::GzipReader(std::FILE* file, const char* prefix, size_t prefixLen, unsigned threads, bool quiet) : state(new State) {
+    state->file = file;
+    state->quiet = quiet;
+    state->threads = std::max(1u, threads);
+    state->prefix.assign(prefix, prefixLen);
+    state->inflaters.reset(new ThreadPool(state->threads));
+    state->readAhead();
+}
+
+GzipReader::~GzipReader() {
+    if (state->ahead.valid()) state->ahead.wait();
+    if (state->inflating) inflateEnd(&state->stream);
+}
+
+long long GzipReader::read(char* buffer, size_t size) {
+    State& s = *state;
+    for (;;) {
+        size_t copied = 0;
+        while (copied < size && s.readyIndex < s.ready.size()) {
+            const std::string& plain = s.ready[s.readyIndex];
+            const size_t n = std::min(size - copied, plain.size() - s.readyOffset);
+            std::memcpy(buffer + copied, plain.data() + s.readyOffset, n);
+            copied += n;
+            s.readyOffset += n;
+            if (s.readyOffset == plain.size()) {
+                s.readyIndex++;
+                s.readyOffset = 0;
+            }
+        }
+        if (copied > 0) return static_cast<long long>(copied);
+        if (!s.parallel) return s.inflateSome(buffer, size);
+        if (!s.ahead.valid()) return 0;
+
+        State::Batch batch = s.ahead.get();
+        if (!batch.ok) return -1;
+        s.ready = std::move(batch.plain);
+        s.readyIndex = 0;
+        s.readyOffset = 0;
+        if (!batch.rest.empty()) {
+            // Not a BGZF member: everything from here on goes through one inflater.
+            s.parallel = false;
+            s.input = std::move(batch.rest);
+            s.inputPos = 0;
+        } else if (!batch.end) {
+            s.readAhead();
+        }
+    }
+}
+
+#else
+
+bool gzipSupported() {
+    return false;
+}
+
+struct GzipBlockCompressor::State {};
+
+GzipBlockCompressor::GzipBlockCompressor(int) {}
+
+GzipBlockCompressor::~GzipBlockCompressor() = default;
+
+bool GzipBlockCompressor::compress(const char*, size_t, std::string&) {
+    return false;
+}
+
+void GzipBlockCompressor::appendEndMember(std::string&) {}
+
+struct GzipReader::State {};
+
+GzipReader::GzipReader(std::FILE*, const char*, size_t, unsigned, bool) {}
+
+GzipReader::~GzipReader() = default;
+
+long long GzipReader::read(char*, size_t) {
+    std::cerr << "Error: This build cannot read gzip input (built without zlib)." << std::endl;
+    return -1;
+}
+
+#endif
+
+}
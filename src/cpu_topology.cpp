@@ -0,0 +1,174 @@
+#include "cpu_topology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sched.h>
+#endif
+
+namespace SudokuApp {
+
+namespace {
+
+    const char* const CPU_ROOT = "/sys/devices/system/cpu/";
+    const char* const NODE_ROOT = "/sys/devices/system/node/";
+
+    bool readUnsigned(const std::string& path, unsigned& value) {
+        std::ifstream in(path);
+        return static_cast<bool>(in >> value);
+    }
+
+    /** @brief Parses a sysfs cpu list such as "0-3,8-11" (also used for node lists). */
+    bool readIdList(const std::string& path, std::vector<unsigned>& ids) {
+        std::ifstream in(path);
+        std::string text;
+        if (!std::getline(in, text)) return false;
+        ids.clear();
+        size_t position = 0;
+        while (position < text.size()) {
+            size_t end = text.find(',', position);
+            if (end == std::string::npos) end = text.size();
+            const std::string item = text.substr(position, end - position);
+            position = end + 1;
+            if (item.empty()) continue;
+            try {
+                const size_t dash = item.find('-');
+                const unsigned first = static_cast<unsigned>(std::stoul(item.substr(0, dash)));
+                const unsigned last = dash == std::string::npos ? first : static_cast<unsigned>(std::stoul(item.substr(dash + 1)));
+                for (unsigned id = first; id <= last; ++id) ids.push_back(id);
+            } catch (...) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** @brief CPU ids the process may run on. */
+    std::vector<unsigned> availableCpus() {
+        std::vector<unsigned> ids;
+#if defined(__linux__)
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (unsigned id = 0; id < CPU_SETSIZE; ++id) {
+                if (CPU_ISSET(id, &mask)) ids.push_back(id);
+            }
+        }
+        if (ids.empty()) readIdList(std::string(CPU_ROOT) + "online", ids);
+#endif
+        if (ids.empty()) {
+            const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned id = 0; id < count; ++id) ids.push_back(id);
+        }
+        return ids;
+    }
+
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+    const std::vector<unsigned> ids = availableCpus();
+
+    // Physical cores are (package, core id) pairs; core ids repeat across packages.
+    std::map<std::pair<unsigned, unsigned>, unsigned> coreIndex;
+    std::vector<unsigned> coreOf(ids.size());
+    bool detected = true;
+    for (size_t i = 0; i < ids.size() && detected; ++i) {
+        const std::string base = std::string(CPU_ROOT) + "cpu" + std::to_string(ids[i]) + "/topology/";
+        unsigned package = 0;
+        unsigned core = 0;
+        detected = readUnsigned(base + "physical_package_id", package) && readUnsigned(base + "core_id", core);
+        const auto entry = coreIndex.emplace(std::make_pair(package, core), static_cast<unsigned>(coreIndex.size())).first;
+        coreOf[i] = entry->second;
+    }
+    std::map<unsigned, unsigned> nodeOf;
+    std::vector<unsigned> onlineNodes;
+    if (detected && readIdList(std::string(NODE_ROOT) + "online", onlineNodes)) {
+        std::vector<unsigned> nodeCpus;
+        for (unsigned node : onlineNodes) {
+            if (!readIdList(std::string(NODE_ROOT) + "node" + std::to_string(node) + "/cpulist", nodeCpus)) continue;
+            for (unsigned id : nodeCpus) nodeOf[id] = node;
+        }
+    }
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        LogicalCpu cpu;
+        cpu.id = ids[i];
+        cpu.core = detected ? coreOf[i] : static_cast<unsigned>(i);
+        const auto node = nodeOf.find(cpu.id);
+        cpu.node = node != nodeOf.end() ? node->second : 0;
+        topology.cpus_.push_back(cpu);
+        if (std::find(topology.nodes_.begin(), topology.nodes_.end(), cpu.node) == topology.nodes_.end()) {
+            topology.nodes_.push_back(cpu.node);
+        }
+    }
+    std::sort(topology.nodes_.begin(), topology.nodes_.end());
+    topology.cores_ = detected ? static_cast<unsigned>(coreIndex.size()) : static_cast<unsigned>(topology.cpus_.size());
+    topology.detected_ = detected;
+    return topology;
+}
+
+std::vector<LogicalCpu> CpuTopology::placement(unsigned threads) const {
+    // cores[node][k] = the CPUs of the k-th core on that node, in id order.
+    std::vector<std::vector<std::vector<LogicalCpu>>> cores(nodes_.size());
+    std::map<unsigned, std::pair<size_t, size_t>> slotOfCore;
+    for (const LogicalCpu& cpu : cpus_) {
+        auto slot = slotOfCore.find(cpu.core);
+        if (slot == slotOfCore.end()) {
+            const size_t node = static_cast<size_t>(std::find(nodes_.begin(), nodes_.end(), cpu.node) - nodes_.begin());
+            slot = slotOfCore.emplace(cpu.core, std::make_pair(node, cores[node].size())).first;
+            cores[node].emplace_back();
+        }
+        cores[slot->second.first][slot->second.second].push_back(cpu);
+    }
+
+    size_t maxCores = 0;
+    size_t maxSiblings = 0;
+    for (const auto& node : cores) {
+        maxCores = std::max(maxCores, node.size());
+        for (const auto& core : node) maxSiblings = std::max(maxSiblings, core.size());
+    }
+    std::vector<LogicalCpu> order;
+    order.reserve(cpus_.size());
+    for (size_t sibling = 0; sibling < maxSiblings; ++sibling) {
+        for (size_t round = 0; round < maxCores; ++round) {
+            for (const auto& node : cores) {
+                if (round < node.size() && sibling < node[round].size()) order.push_back(node[round][sibling]);
+            }
+        }
+    }
+
+    std::vector<LogicalCpu> result;
+    if (order.empty()) return result;
+    result.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) result.push_back(order[i % order.size()]);
+    return result;
+}
+
+bool pinCurrentThread(unsigned cpu) {
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) return false;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#elif defined(_WIN32)
+    if (cpu >= 8 * sizeof(DWORD_PTR)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,186 @@
+#include "dlx_solver.hpp"
+
+#include <cstring>
+
+namespace SudokuApp {
+
+namespace {
+
+    // Row r of the matrix places digit (r % 9) + 1 in cell r / 9.
+    inline int rowOf(int cell, int digitIndex) { return cell * 9 + digitIndex; }
+
+}
+
+DlxSolver::DlxSolver() {
+    for (int h = 0; h <= COLUMNS; ++h) {
+        left[h] = static_cast<uint16_t>(h == 0 ? COLUMNS : h - 1);
+        right[h] = static_cast<uint16_t>(h == COLUMNS ? 0 : h + 1);
+        up[h] = down[h] = column[h] = static_cast<uint16_t>(h);
+        size[h] = 0;
+    }
+
+    for (int r = 0; r < ROWS; ++r) {
+        const int cell = r / 9, d = r % 9;
+        const int row = cell / 9, col = cell % 9, box = (row / 3) * 3 + col / 3;
+        const int headers[4] = {
+            1 + cell,
+            1 + 81 + row * 9 + d,
+            1 + 162 + col * 9 + d,
+            1 + 243 + box * 9 + d,
+        };
+        const int first = FIRST_ROW_NODE + r * 4;
+        for (int k = 0; k < 4; ++k) {
+            const int node = first + k;
+            const int h = headers[k];
+            left[node] = static_cast<uint16_t>(first + (k + 3) % 4);
+            right[node] = static_cast<uint16_t>(first + (k + 1) % 4);
+            // Append at the bottom of the column, so rows stay in increasing order.
+            column[node] = static_cast<uint16_t>(h);
+            up[node] = up[h];
+            down[node] = static_cast<uint16_t>(h);
+            down[up[h]] = static_cast<uint16_t>(node);
+            up[h] = static_cast<uint16_t>(node);
+            size[h]++;
+        }
+    }
+    memset(grid, '0', sizeof(grid));
+}
+
+
+void DlxSolver::cover(int header) {
+    right[left[header]] = right[header];
+    left[right[header]] = left[header];
+    for (int i = down[header]; i != header; i = down[i]) {
+        for (int j = right[i]; j != i; j = right[j]) {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            size[column[j]]--;
+        }
+    }
+}
+
+
+void DlxSolver::uncover(int header) {
+    for (int i = up[header]; i != header; i = up[i]) {
+        for (int j = left[i]; j != i; j = left[j]) {
+            size[column[j]]++;
+            down[up[j]] = static_cast<uint16_t>(j);
+            up[down[j]] = static_cast<uint16_t>(j);
+        }
+    }
+    right[left[header]] = static_cast<uint16_t>(header);
+    left[right[header]] = static_cast<uint16_t>(header);
+}
+
+
+// Covers the columns of `node`'s row other than `node`'s own (already covered by the caller).
+void DlxSolver::selectRow(int node) {
+    for (int j = right[node]; j != node; j = right[j]) cover(column[j]);
+}
+
+
+void DlxSolver::unselectRow(int node) {
+    for (int j = left[node]; j != node; j = left[j]) uncover(column[j]);
+}
+
+
+int DlxSolver::chooseColumn() const {
+    int best = -1;
+    int bestSize = ROWS + 1;
+    for (int h = right[ROOT]; h != ROOT; h = right[h]) {
+        if (size[h] < bestSize) {
+            bestSize = size[h];
+            best = h;
+            if (bestSize <= 1) break;
+        }
+    }
+    return best;
+}
+
+
+void DlxSolver::restore() {
+    while (selectedCount > 0) {
+        const int node = selected[--selectedCount];
+        unselectRow(node);
+        uncover(column[node]);
+    }
+    givenCount = 0;
+}
+
+
+bool DlxSolver::initialize(const char* puzzle_data, size_t len) {
+    restore();
+    if (len != 81 || puzzle_data == nullptr) return false;
+
+    uint16_t rows[9] = {0}, cols[9] = {0}, boxes[9] = {0};
+    for (int cell = 0; cell < 81; ++cell) {
+        const char c = puzzle_data[cell];
+        if (c < '1' || c > '9') { grid[cell] = '0'; continue; }
+        grid[cell] = c;
+        const int row = cell / 9, col = cell % 9, box = (row / 3) * 3 + col / 3;
+        const uint16_t mask = static_cast<uint16_t>(1 << (c - '0'));
+        if ((rows[row] | cols[col] | boxes[box]) & mask) return false;
+        rows[row] |= mask; cols[col] |= mask; boxes[box] |= mask;
+
+        const int node = FIRST_ROW_NODE + rowOf(cell, c - '1') * 4;
+        cover(column[node]);
+        selectRow(node);
+        selected[selectedCount++] = static_cast<uint16_t>(node);
+    }
+    givenCount = selectedCount;
+    return true;
+}
+
+
+// Iterative Algorithm X: `selected[givenCount..selectedCount)` is the stack of chosen rows,
+// one per level; backtracking moves a level to the next row of the same column.
+SolveResult DlxSolver::solve() {
+    tracker.start(budget);
+    SUDOKU_STAT(stats = SearchStats());
+    for (;;) {
+        const int header = chooseColumn();
+        if (header < 0) break;
+        if (tracker.step()) return SolveResult::Aborted;
+        SUDOKU_STAT(stats.nodes++);
+
+        if (size[header] > 0) {
+            SUDOKU_STAT(if (size[header] > 1) stats.guesses++);
+            cover(header);
+            const int node = down[header];
+            selectRow(node);
+            selected[selectedCount++] = static_cast<uint16_t>(node);
+            continue;
+        }
+
+        // Dead end: advance the deepest level that still has rows to try.
+        bool advanced = false;
+        while (selectedCount > givenCount) {
+            const int node = selected[--selectedCount];
+            unselectRow(node);
+            const int h = column[node];
+            const int next = down[node];
+            SUDOKU_STAT(stats.backtracks++);
+            if (next != h) {
+                selectRow(next);
+                selected[selectedCount++] = static_cast<uint16_t>(next);
+                advanced = true;
+                break;
+            }
+            uncover(h);
+        }
+        if (!advanced) return SolveResult::Unsolvable;
+    }
+
+    for (int k = givenCount; k < selectedCount; ++k) {
+        const int r = (selected[k] - FIRST_ROW_NODE) / 4;
+        grid[r / 9] = static_cast<char>('1' + r % 9);
+    }
+    return SolveResult::Solved;
+}
+
+
+const char* DlxSolver::getSolution() const {
+    return grid;
+}
+
+}
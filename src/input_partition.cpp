@@ -0,0 +1,211 @@
+#include "input_partition.hpp"
+#include "compressed_stream.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <filesystem>
+
+namespace SudokuApp {
+
+namespace {
+
+    /**
+     * @brief Returns the offset of the first line start at or after `target`.
+     * Reads forward from `target - 1` in small blocks until a '\n' is found.
+     */
+    uint64_t alignToLineStart(std::ifstream& file, uint64_t target, uint64_t fileSize) {
+        if (target == 0 || target >= fileSize) return std::min(target, fileSize);
+
+        constexpr size_t PROBE_SIZE = 4096;
+        char buffer[PROBE_SIZE];
+        uint64_t pos = target - 1;
+
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(pos));
+        while (pos < fileSize && file) {
+            file.read(buffer, PROBE_SIZE);
+            const std::streamsize got = file.gcount();
+            if (got <= 0) break;
+            for (std::streamsize i = 0; i < got; ++i) {
+                if (buffer[i] == '\n') return pos + static_cast<uint64_t>(i) + 1;
+            }
+            pos += static_cast<uint64_t>(got);
+        }
+        return fileSize;
+    }
+
+    /**
+     * @brief Cuts [0, fileSize) at `parts` evenly spaced targets, moving each cut with `align`.
+     * `align(target)` is only called for 0 < target < fileSize and must return a line start >= target.
+     */
+    template <typename AlignFn>
+    std::vector<ByteRange> cutRanges(uint64_t fileSize, uint64_t parts, AlignFn align) {
+        std::vector<ByteRange> ranges;
+        if (fileSize == 0) return ranges;
+        if (parts == 0) parts = 1;
+        if (parts > fileSize) parts = fileSize;
+
+        ranges.reserve(static_cast<size_t>(parts));
+        uint64_t begin = 0;
+        for (uint64_t i = 1; i <= parts && begin < fileSize; ++i) {
+            uint64_t end = fileSize;
+            if (i < parts) {
+                const uint64_t target = fileSize / parts * i + (fileSize % parts) * i / parts;
+                end = (target <= begin) ? begin : align(target);
+            }
+            if (end > begin) {
+                ranges.push_back({begin, end});
+                begin = end;
+            }
+        }
+        return ranges;
+    }
+
+}
+
+bool queryInputSize(const std::string& filename, uint64_t& size) {
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(filename, ec);
+    if (ec) {
+        std::cerr << "Error: Cannot stat input file: " << filename << " (" << ec.message() << ")" << std::endl;
+        return false;
+    }
+    size = static_cast<uint64_t>(fileSize);
+    return true;
+}
+
+std::vector<ByteRange> partitionInput(const std::string& filename, uint64_t fileSize, uint64_t parts) {
+    std::ifstream file(filename, std::ios::binary);
+    if (fileSize > 0 && !file) {
+        std::cerr << "Error: Cannot open input file for partitioning: " << filename << std::endl;
+        return {};
+    }
+    return cutRanges(fileSize, parts, [&](uint64_t target) { return alignToLineStart(file, target, fileSize); });
+}
+
+std::vector<ByteRange> partitionInput(const char* data, uint64_t fileSize, uint64_t parts) {
+    return cutRanges(fileSize, parts, [&](uint64_t target) {
+        const void* newline = std::memchr(data + target - 1, '\n', static_cast<size_t>(fileSize - target + 1));
+        return newline ? static_cast<uint64_t>(static_cast<const char*>(newline) - data) + 1 : fileSize;
+    });
+}
+
+uint64_t countRecords(const char* data, uint64_t fileSize, ByteRange range) {
+    uint64_t count = 0;
+    const char* cursor = data + range.begin;
+    const char* const end = data + range.end;
+    while (cursor < end) {
+        const void* newline = std::memchr(cursor, '\n', static_cast<size_t>(end - cursor));
+        if (newline == nullptr) break;
+        cursor = static_cast<const char*>(newline) + 1;
+        count++;
+    }
+    if (range.end == fileSize && range.end > range.begin && data[range.end - 1] != '\n') count++;
+    return count;
+}
+
+bool countRecords(const std::string& filename, uint64_t fileSize, ByteRange range, uint64_t& count) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Cannot open input file for counting: " << filename << std::endl;
+        return false;
+    }
+    file.seekg(static_cast<std::streamoff>(range.begin));
+
+    constexpr size_t COUNT_BUFFER_SIZE = 1 << 16;
+    std::vector<char> buffer(COUNT_BUFFER_SIZE);
+    count = 0;
+    uint64_t remaining = range.end - range.begin;
+    char last = '\n';
+    while (remaining > 0 && file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(std::min<uint64_t>(remaining, buffer.size())));
+        const std::streamsize got = file.gcount();
+        if (got <= 0) break;
+        count += static_cast<uint64_t>(std::count(buffer.data(), buffer.data() + got, '\n'));
+        last = buffer[static_cast<size_t>(got) - 1];
+        remaining -= static_cast<uint64_t>(got);
+    }
+    // A short read (an I/O error, or the file shrank) would shift every later chunk's records.
+    if (remaining > 0) {
+        std::cerr << "Error: Failed reading input file for counting: " << filename << std::endl;
+        return false;
+    }
+    if (range.end == fileSize && range.end > range.begin && last != '\n') count++;
+    return true;
+}
+
+unsigned gridSizeForCells(size_t cells) {
+    switch (cells) {
+        case 16: return 4;
+        case 256: return 16;
+        case 625: return 25;
+        default: return 9;
+    }
+}
+
+namespace {
+
+    /** Non-blank lines that must agree on the grid size. */
+    constexpr size_t GRID_SAMPLE_LINES = 8;
+
+    size_t nonBlankCount(const std::string& line) {
+        return static_cast<size_t>(std::count_if(line.begin(), line.end(),
+            [](char c) { return !std::isspace(static_cast<unsigned char>(c)); }));
+    }
+
+    /** @brief The grid size all of the first GRID_SAMPLE_LINES non-blank lines agree on; 0 if they do not. */
+    unsigned sampledGridSize(std::istream& lines) {
+        std::string line;
+        unsigned gridSize = 0;
+        size_t sampled = 0;
+        while (sampled < GRID_SAMPLE_LINES && std::getline(lines, line)) {
+            const size_t cells = nonBlankCount(line);
+            if (cells == 0) continue;
+            const unsigned size = gridSizeForCells(cells);
+            if (gridSize != 0 && size != gridSize) return 0;
+            gridSize = size;
+            sampled++;
+        }
+        return gridSize != 0 ? gridSize : 9;
+    }
+
+    /** @brief True once `text` holds GRID_SAMPLE_LINES whole lines with something other than blanks on them. */
+    bool hasSampleLines(const std::string& text) {
+        size_t sampled = 0;
+        for (size_t begin = 0, end; sampled < GRID_SAMPLE_LINES && (end = text.find('\n', begin)) != std::string::npos; begin = end + 1) {
+            if (nonBlankCount(text.substr(begin, end - begin)) != 0) sampled++;
+        }
+        return sampled == GRID_SAMPLE_LINES;
+    }
+
+}
+
+unsigned detectGridSize(const std::string& filename) {
+    if (!startsWithGzipMagic(filename)) {
+        std::ifstream file(filename, std::ios::binary);
+        return sampledGridSize(file);
+    }
+    // Gzip input: inflate only up to the sampled lines.
+    std::string text;
+    std::FILE* file = gzipSupported() ? std::fopen(filename.c_str(), "rb") : nullptr;
+    if (file != nullptr) {
+        {
+            // Errors are left to the run, which reads the same stream again.
+            GzipReader reader(file, "", 0, 1, true);
+            char buffer[1 << 14];
+            long long n = 0;
+            while (!hasSampleLines(text) && (n = reader.read(buffer, sizeof(buffer))) > 0) text.append(buffer, static_cast<size_t>(n));
+        }
+        std::fclose(file);
+    }
+    std::istringstream lines(text);
+    return sampledGridSize(lines);
+}
+
+}
@@ -0,0 +1,36 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SudokuApp {
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+    total += other.total;
+    sum += other.sum;
+    maximum = std::max(maximum, other.maximum);
+}
+
+
+uint64_t LatencyHistogram::upperBound(int index) {
+    if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+    const int shift = (index >> SUB_BITS) - 1;
+    const uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + (index & (SUB_BUCKETS - 1))) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+
+uint64_t LatencyHistogram::percentile(double percent) const {
+    if (total == 0) return 0;
+    const double clamped = std::min(100.0, std::max(0.0, percent));
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(upperBound(i), maximum);
+    }
+    return maximum;
+}
+
+}
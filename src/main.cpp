@@ -1,208 +1,231 @@
-#include "worker.hpp"
+#include "compressed_stream.hpp"
+#include "packed_format.hpp"
+#include "run_solver.hpp"
 
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
-#include <thread>
-#include <atomic>
 #include <algorithm>
 #include <exception>
-#include <iterator>
-#include <functional>
-#include <stdexcept>
-#include <cstdio>
+#include <cstdint>
 
 namespace {
 
-    size_t countTotalLines(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file) {
-            std::cerr << "Error: Cannot open file for line counting: " << filename << std::endl;
-            return 0;
-        }
-        size_t lines = std::count(std::istreambuf_iterator<char>(file),
-                                  std::istreambuf_iterator<char>(), '\n');
-        file.clear();
-        file.seekg(0, std::ios::end);
-        if (file.tellg() > 0) {
-            file.seekg(-1, std::ios::end);
-            char last_char;
-            if (file.get(last_char)) { if (last_char != '\n') lines++; }
-            else { if(lines == 0) lines = 1; }
-        }
-        return lines;
-    }
-    size_t countPuzzleLines(const std::string& filename) {
-        std::ifstream file(filename); if (!file) return 0;
-        size_t count = 0; std::string line;
-        while (std::getline(file, line)) {
-            line.erase(std::remove_if(line.begin(), line.end(),
-                [](unsigned char c) { return std::isspace(c); }), line.end());
-            if (line.size() == 81) count++;
-        }
-        return count;
+    bool parseUnsigned(const std::string& text, uint64_t& value) {
+        if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+        try { value = std::stoull(text); } catch (...) { return false; }
+        return true;
     }
-    unsigned determineThreadCount(const std::string& cmdLineArg, size_t totalLines) {
-        unsigned numThreads = 0;
-        if (!cmdLineArg.empty()) {
-            try {
-                int nt = std::stoi(cmdLineArg);
-                if (nt > 0) numThreads = static_cast<unsigned>(nt);
-                else std::cerr << "Warning: Invalid thread count '" << cmdLineArg << "'. Auto-detecting.\n";
-            } catch (...) { std::cerr << "Warning: Invalid thread count '" << cmdLineArg << "'. Auto-detecting.\n"; }
-        }
-        if (numThreads == 0) {
-            unsigned hardware_threads = std::thread::hardware_concurrency();
-            if (hardware_threads > 0) {
-                if (hardware_threads > 4) numThreads = std::max(1u, hardware_threads / 2);
-                else numThreads = hardware_threads;
-                std::cout << "Auto-detecting threads: " << numThreads << std::endl;
-            } else { std::cout << "Warning: Cannot detect concurrency. Using 1 thread." << std::endl; numThreads = 1; }
-        }
-        unsigned maxPossibleThreads = (totalLines == 0) ? 1 : static_cast<unsigned>(totalLines);
-        numThreads = std::min(numThreads, maxPossibleThreads);
-        numThreads = std::max(1u, numThreads);
-        return numThreads;
-    }
-
 
-    /**
-     * @brief Concatenates temporary part files into the final output file.
-     * Also cleans up the temporary files afterwards.
-     * @param finalOutputFilename The name of the final output file.
-     * @param tempFilePrefix The prefix used for temporary files.
-     * @param numThreads The number of worker threads (and thus part files).
-     * @return true on success, false if any file operation fails.
-     */
-    bool concatenateOutputFiles(const std::string& finalOutputFilename,
-                                const std::string& tempFilePrefix,
-                                unsigned numThreads)
-    {
-        std::cout << "Concatenating temporary files into " << finalOutputFilename << "..." << std::endl;
-        std::ofstream finalOutputFile(finalOutputFilename);
-        if (!finalOutputFile) {
-            std::cerr << "Error: Cannot open final output file for writing: " << finalOutputFilename << std::endl;
-            return false;
-        }
-
-        constexpr size_t READ_BUFFER_SIZE = 8192;
-        std::vector<char> buffer(READ_BUFFER_SIZE);
+    /** @brief The thread-count argument; 0 (auto-detect) if it is missing or not a positive number. */
+    unsigned parseThreadCount(const std::string& cmdLineArg) {
+        if (cmdLineArg.empty()) return 0;
+        try {
+            int nt = std::stoi(cmdLineArg);
+            if (nt > 0) return static_cast<unsigned>(nt);
+        } catch (...) {}
+        std::cerr << "Warning: Invalid thread count '" << cmdLineArg << "'. Auto-detecting.\n";
+        return 0;
+    }
 
-        bool success = true;
+}
 
-        for (unsigned i = 0; i < numThreads; ++i) {
-            std::string tempFilename = tempFilePrefix + std::to_string(i) + ".tmp";
-            std::ifstream tempInputFile(tempFilename, std::ios::binary);
 
-            if (!tempInputFile) {
-                 std::cerr << "Warning: Could not open temporary file: " << tempFilename << ". Skipping." << std::endl;
-                continue;
+int main(int argc, char* argv[]) {
+    try {
+        SudokuApp::RunConfig config;
+        SudokuApp::RecordMarkers& markers = config.markers;
+        SudokuApp::SolveOptions& options = config.solve;
+        bool printReport = false;
+        bool printStats = false;
+        SudokuApp::StatsFormat statsFormat = SudokuApp::StatsFormat::Text;
+        uint64_t retryFactor = 0;
+        enum class Convert { None, Pack, Unpack } convert = Convert::None;
+        uint64_t blockRecords = SudokuApp::DEFAULT_PACKED_BLOCK_RECORDS;
+
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--reader=mmap") config.useMappedReader = true;
+            else if (arg == "--reader=stream") config.useMappedReader = false;
+            else if (arg.rfind("--mark-invalid=", 0) == 0 || arg.rfind("--mark-unsolvable=", 0) == 0 || arg.rfind("--mark-aborted=", 0) == 0) {
+                auto& marker = arg.rfind("--mark-invalid=", 0) == 0 ? markers.invalid
+                             : arg.rfind("--mark-unsolvable=", 0) == 0 ? markers.unsolvable : markers.aborted;
+                const std::string spec = arg.substr(arg.find('=') + 1);
+                if (!SudokuApp::RecordMarkers::parse(spec, marker)) {
+                    std::cerr << "Error: Marker must be a single character or 81 characters (not a full grid): '" << spec << "'" << std::endl;
+                    return 1;
+                }
             }
-
-            while (tempInputFile.read(buffer.data(), buffer.size())) {
-                finalOutputFile.write(buffer.data(), tempInputFile.gcount());
-                if(!finalOutputFile) {
-                    std::cerr << "Error: Failed writing to final output file: " << finalOutputFilename << std::endl;
-                    success = false; break;
+            else if (arg.rfind("--chunk-size=", 0) == 0) {
+                try { config.chunkBytes = std::stoull(arg.substr(13)); } catch (...) { config.chunkBytes = 0; }
+                if (config.chunkBytes == 0) {
+                    std::cerr << "Error: Invalid chunk size '" << arg.substr(13) << "'." << std::endl;
+                    return 1;
                 }
             }
-            if (success && tempInputFile.gcount() > 0) {
-                finalOutputFile.write(buffer.data(), tempInputFile.gcount());
-                 if(!finalOutputFile) {
-                    std::cerr << "Error: Failed writing final part to output file: " << finalOutputFilename << std::endl;
-                    success = false;
+            else if (arg.rfind("--size=", 0) == 0) {
+                uint64_t size = 0;
+                if (!parseUnsigned(arg.substr(7), size) || (size != 4 && size != 9 && size != 16 && size != 25)) {
+                    std::cerr << "Error: Invalid grid size '" << arg.substr(7) << "' (4, 9, 16 or 25)." << std::endl;
+                    return 1;
                 }
+                config.gridSize = static_cast<unsigned>(size);
             }
-             if(!success) break;
-
-            tempInputFile.close();
-
-            if (std::remove(tempFilename.c_str()) != 0) {
-                 std::cerr << "Warning: Could not remove temporary file: " << tempFilename << std::endl;
+            else if (arg == "--engine=scalar") options.engine = SudokuApp::SolverEngine::Scalar;
+            else if (arg == "--engine=batch") options.engine = SudokuApp::SolverEngine::Batch;
+            else if (arg == "--engine=dlx") options.engine = SudokuApp::SolverEngine::Dlx;
+            else if (arg.rfind("--count=", 0) == 0) {
+                if (!parseUnsigned(arg.substr(8), options.countLimit) || options.countLimit == 0) {
+                    std::cerr << "Error: Invalid solution count limit '" << arg.substr(8) << "'." << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg.rfind("--max-nodes=", 0) == 0) {
+                if (!parseUnsigned(arg.substr(12), options.budget.maxNodes)) {
+                    std::cerr << "Error: Invalid node budget '" << arg.substr(12) << "'." << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg.rfind("--max-ms=", 0) == 0) {
+                uint64_t millis = 0;
+                if (!parseUnsigned(arg.substr(9), millis) || millis > UINT32_MAX) {
+                    std::cerr << "Error: Invalid time budget '" << arg.substr(9) << "'." << std::endl;
+                    return 1;
+                }
+                options.budget.maxMillis = static_cast<uint32_t>(millis);
+            }
+            else if (arg == "--retry" || arg.rfind("--retry=", 0) == 0) {
+                options.retryAborted = true;
+                if (arg.size() > 7 && !parseUnsigned(arg.substr(8), retryFactor)) {
+                    std::cerr << "Error: Invalid retry factor '" << arg.substr(8) << "'." << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--cache" || arg.rfind("--cache=", 0) == 0) {
+                config.useCache = true;
+                config.cachePath = arg.size() > 7 ? arg.substr(8) : std::string();
+            }
+            else if (arg.rfind("--cache-entries=", 0) == 0) {
+                uint64_t entries = 0;
+                if (!parseUnsigned(arg.substr(16), entries) || entries == 0) {
+                    std::cerr << "Error: Invalid cache size '" << arg.substr(16) << "'." << std::endl;
+                    return 1;
+                }
+                config.cacheEntries = static_cast<size_t>(entries);
+            }
+            else if (arg == "--pin") config.pinThreads = true;
+            else if (arg == "--stream") config.streamMode = true;
+            else if (arg == "--split-search") config.splitSearch = true;
+            else if (arg == "--verify") config.verify = true;
+            else if (arg == "--checkpoint") config.checkpoint = true;
+            else if (arg == "--gzip" || arg.rfind("--gzip=", 0) == 0) {
+                uint64_t level = SudokuApp::DEFAULT_GZIP_LEVEL;
+                if (arg.size() > 6 && (!parseUnsigned(arg.substr(7), level) || level > 9)) {
+                    std::cerr << "Error: Invalid gzip level '" << arg.substr(7) << "' (0-9)." << std::endl;
+                    return 1;
+                }
+                config.stream.gzipLevel = static_cast<int>(level);
+            }
+            else if (arg.rfind("--stream-slots=", 0) == 0) {
+                uint64_t slots = 0;
+                if (!parseUnsigned(arg.substr(15), slots) || slots < 2 || slots > 65536) {
+                    std::cerr << "Error: Invalid stream slot count '" << arg.substr(15) << "' (2-65536)." << std::endl;
+                    return 1;
+                }
+                config.stream.slots = static_cast<size_t>(slots);
             }
+            else if (arg == "--output-format=text") options.output = SudokuApp::OutputFormat::Text;
+            else if (arg == "--output-format=packed") options.output = SudokuApp::OutputFormat::Packed;
+            else if (arg == "--pack") convert = Convert::Pack;
+            else if (arg == "--unpack") convert = Convert::Unpack;
+            else if (arg.rfind("--block-records=", 0) == 0) {
+                if (!parseUnsigned(arg.substr(16), blockRecords) || blockRecords == 0 || blockRecords > UINT32_MAX) {
+                    std::cerr << "Error: Invalid block size '" << arg.substr(16) << "'." << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--progress" || arg.rfind("--progress=", 0) == 0) {
+                config.progress.intervalSeconds = SudokuApp::DEFAULT_PROGRESS_SECONDS;
+                if (arg.size() > 10) {
+                    uint64_t seconds = 0;
+                    if (!parseUnsigned(arg.substr(11), seconds) || seconds == 0) {
+                        std::cerr << "Error: Invalid progress interval '" << arg.substr(11) << "'." << std::endl;
+                        return 1;
+                    }
+                    config.progress.intervalSeconds = static_cast<double>(seconds);
+                }
+            }
+            else if (arg.rfind("--status-file=", 0) == 0) {
+                config.progress.statusFile = arg.substr(14);
+                if (config.progress.statusFile.empty()) {
+                    std::cerr << "Error: --status-file needs a file name." << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--report") printReport = true;
+            else if (arg == "--stats" || arg == "--stats=text") printStats = true;
+            else if (arg == "--stats=json") { printStats = true; statsFormat = SudokuApp::StatsFormat::Json; }
+            else if (arg.rfind("--", 0) == 0) std::cerr << "Warning: Ignoring unknown option '" << arg << "'.\n";
+            else positional.push_back(arg);
         }
-
-        finalOutputFile.close();
-
-        if(!success) {
-           std::cerr << "Concatenation failed due to errors." << std::endl;
+        // The converters only translate between text and packed files; nothing is solved.
+        if (convert != Convert::None) {
+            if (positional.size() < 2) {
+                std::cerr << "Error: --pack and --unpack need an input and an output file." << std::endl;
+                return 1;
+            }
+            const bool converted = convert == Convert::Pack
+                ? SudokuApp::packTextFile(positional[0], positional[1], static_cast<uint32_t>(blockRecords))
+                : SudokuApp::unpackTextFile(positional[0], positional[1], markers);
+            return converted ? 0 : 1;
         }
-        return success;
-    }
-
-
-}
-
-
-int main(int argc, char* argv[]) {
-    try {
-        std::string inputFilename = "input.txt";
-        std::string outputFilename = "output.txt";
-        std::string threadsArg = "";
-        const std::string tempFilePrefix = outputFilename + "_part_";
-
-        if (argc > 1) inputFilename = argv[1];
-        if (argc > 2) outputFilename = argv[2];
-        if (argc > 3) threadsArg = argv[3];
-
-        size_t puzzleCount = countPuzzleLines(inputFilename);
-        size_t totalLines = countTotalLines(inputFilename);
-        if (totalLines == 0) {
-             std::cout << "Input file is empty or unreadable. Exiting." << std::endl;
-             return (puzzleCount > 0) ? 1 : 0;
+        if (options.countLimit != 0 && options.engine != SudokuApp::SolverEngine::Scalar) {
+            std::cerr << "Warning: --count uses the scalar engine." << std::endl;
+            options.engine = SudokuApp::SolverEngine::Scalar;
         }
-
-        unsigned numThreads = determineThreadCount(threadsArg, totalLines);
-
-        std::vector<std::thread> workers;
-        std::atomic<size_t> solvedCounter(0);
-        std::atomic<size_t> processedCounter(0);
-        std::atomic<bool> workerErrorFlag(false);
-
-
-        size_t startLine = 0;
-        size_t linesPerThread = (totalLines + numThreads - 1) / numThreads;
-        workers.reserve(numThreads);
-
-        for (unsigned i = 0; i < numThreads; ++i) {
-            size_t endLine = std::min(startLine + linesPerThread, totalLines);
-            if (startLine < endLine) {
-                workers.emplace_back(SudokuApp::solverWorker,
-                                     i,
-                                     std::cref(inputFilename),
-                                     std::cref(tempFilePrefix),
-                                     startLine,
-                                     endLine,
-                                     std::ref(solvedCounter),
-                                     std::ref(processedCounter),
-                                     std::ref(workerErrorFlag));
-            }
-            startLine = endLine;
-            if (startLine >= totalLines) break;
+        if (config.splitSearch && options.engine != SudokuApp::SolverEngine::Scalar) {
+            std::cerr << "Warning: --split-search uses the scalar engine." << std::endl;
+            options.engine = SudokuApp::SolverEngine::Scalar;
         }
-
-        for (auto& t : workers) {
-            if (t.joinable()) {
-                 t.join();
-            }
+        if (options.countLimit != 0 && config.useCache) {
+            std::cerr << "Warning: --cache is ignored with --count." << std::endl;
+            config.useCache = false;
         }
-
-        bool concatenation_ok = false;
-        if (workerErrorFlag.load()) {
-             std::cerr << "One or more workers reported an error. Skipping concatenation." << std::endl;
-             for (unsigned i = 0; i < numThreads; ++i) std::remove((tempFilePrefix + std::to_string(i) + ".tmp").c_str());
-        } else {
-            concatenation_ok = concatenateOutputFiles(outputFilename, tempFilePrefix, numThreads);
+        // A status file alone still needs a reporting interval.
+        if (!config.progress.statusFile.empty() && !config.progress.enabled()) config.progress.intervalSeconds = SudokuApp::DEFAULT_PROGRESS_SECONDS;
+        // The retry pass gets `retryFactor` times the first budget; no factor means no limit.
+        if (retryFactor != 0) {
+            options.retryBudget.maxNodes = options.budget.maxNodes * retryFactor;
+            options.retryBudget.maxMillis = static_cast<uint32_t>(std::min<uint64_t>(UINT32_MAX, uint64_t(options.budget.maxMillis) * retryFactor));
         }
-
-
-        if(!workerErrorFlag.load() && !concatenation_ok) {
-             std::cout << "  WARNING: Concatenation step failed!" << std::endl;
-        } else if (workerErrorFlag.load()){
-             std::cout << "  WARNING: Worker error occurred during processing!" << std::endl;
+        if (positional.size() > 0) config.inputFilename = positional[0];
+        if (positional.size() > 1) config.outputFilename = positional[1];
+        const std::string& outputName = config.outputFilename;
+        if (outputName.size() > 3 && outputName.compare(outputName.size() - 3, 3, ".gz") == 0 && config.stream.gzipLevel < 0) {
+            config.stream.gzipLevel = SudokuApp::DEFAULT_GZIP_LEVEL;
         }
+        if (positional.size() > 2) config.threads = parseThreadCount(positional[2]);
 
+        // stdout may carry the records in stream mode, so messages go to stderr there.
+        const bool streaming = config.streamMode || config.inputFilename == "-" || config.outputFilename == "-";
+        if (options.output == SudokuApp::OutputFormat::Packed && (streaming || config.splitSearch || options.countLimit != 0)) {
+            std::cerr << "Error: Packed output needs file mode and cannot be combined with --count or --split-search." << std::endl;
+            return 1;
+        }
+        SudokuApp::RunStats run;
+        const SudokuApp::RunResult result = SudokuApp::runSolver(config, run, streaming ? std::cerr : std::cout);
+        if (result == SudokuApp::RunResult::EmptyInput) return 0;
+        if (result == SudokuApp::RunResult::Failed && run.threads == 0) return 1;
+
+        if (printStats) {
+            SudokuApp::printRunStats(run, statsFormat, std::cerr);
+        } else if (printReport) {
+            SudokuApp::printLoadReport(run.loads, run.chunks, run.solveWallSeconds, std::cerr);
+        }
+        if (result == SudokuApp::RunResult::Failed) return 1;
+        // Like `cmp`: a verification that finds bad records fails.
+        if (config.verify && run.solved != run.records) return 1;
 
     } catch (const std::exception& e) {
         std::cerr << "An unexpected error occurred: " << e.what() << std::endl;
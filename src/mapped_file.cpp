@@ -0,0 +1,144 @@
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+namespace SudokuApp {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#if defined(_WIN32)
+        std::swap(fileHandle_, other.fileHandle_);
+        std::swap(mappingHandle_, other.mappingHandle_);
+#endif
+    }
+    return *this;
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: Cannot open file for mapping: " << filename << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        std::cerr << "Error: Cannot query size of file: " << filename << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle_ = file;
+    size_ = static_cast<uint64_t>(fileSize.QuadPart);
+    if (size_ == 0) return true;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        std::cerr << "Error: Cannot create file mapping for: " << filename << std::endl;
+        close();
+        return false;
+    }
+    mappingHandle_ = mapping;
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        std::cerr << "Error: Cannot map view of file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+    if (mappingHandle_ != nullptr) CloseHandle(static_cast<HANDLE>(mappingHandle_));
+    if (fileHandle_ != nullptr) CloseHandle(static_cast<HANDLE>(fileHandle_));
+    data_ = nullptr;
+    size_ = 0;
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+}
+
+void MappedFile::release(uint64_t, uint64_t) const {
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open file for mapping: " << filename << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error: Cannot stat file: " << filename << " (" << std::strerror(errno) << ")" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    size_ = static_cast<uint64_t>(st.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(size_), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file.
+    if (addr == MAP_FAILED) {
+        std::cerr << "Error: Cannot mmap file: " << filename << " (" << std::strerror(errno) << ")" << std::endl;
+        size_ = 0;
+        return false;
+    }
+    madvise(addr, static_cast<size_t>(size_), MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(addr);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) munmap(const_cast<char*>(data_), static_cast<size_t>(size_));
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void MappedFile::release(uint64_t begin, uint64_t end) const {
+    if (data_ == nullptr) return;
+    static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    if (end > size_) end = size_;
+    const uint64_t first = begin / pageSize * pageSize;
+    const uint64_t last = std::min((end + pageSize - 1) / pageSize * pageSize, size_);
+    if (last <= first) return;
+    madvise(const_cast<char*>(data_) + first, static_cast<size_t>(last - first), MADV_DONTNEED);
+}
+
+#endif
+
+}
@@ -0,0 +1,131 @@
+#include "output_file.hpp"
+
+#include <iostream>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+namespace SudokuApp {
+
+PositionalOutputFile::~PositionalOutputFile() {
+    close();
+}
+
+#if defined(_WIN32)
+
+bool PositionalOutputFile::open(const std::string& filename, uint64_t size, uint64_t origin, bool keep) {
+    close();
+    origin_ = origin;
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr,
+                              keep ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: Cannot open output file for writing: " << filename << std::endl;
+        return false;
+    }
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        std::cerr << "Error: Cannot preallocate " << size << " bytes for output file: " << filename << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+    handle_ = file;
+    return true;
+}
+
+void PositionalOutputFile::close() {
+    if (handle_ != nullptr) CloseHandle(static_cast<HANDLE>(handle_));
+    handle_ = nullptr;
+}
+
+bool PositionalOutputFile::writeAt(uint64_t offset, const char* data, size_t len) const {
+    offset += origin_;
+    while (len > 0) {
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        const DWORD chunk = static_cast<DWORD>(len > 0x40000000u ? 0x40000000u : len);
+        DWORD written = 0;
+        if (!WriteFile(static_cast<HANDLE>(handle_), data, chunk, &written, &overlapped) || written == 0) return false;
+        data += written;
+        len -= written;
+        offset += written;
+    }
+    return true;
+}
+
+bool PositionalOutputFile::sync() const {
+    return FlushFileBuffers(static_cast<HANDLE>(handle_)) != 0;
+}
+
+#else
+
+bool PositionalOutputFile::open(const std::string& filename, uint64_t size, uint64_t origin, bool keep) {
+    close();
+    origin_ = origin;
+    const int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | (keep ? 0 : O_TRUNC), 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open output file for writing: " << filename << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Error: Cannot size output file: " << filename << " (" << std::strerror(errno) << ")" << std::endl;
+        ::close(fd);
+        return false;
+    }
+#if defined(__linux__)
+    // Reserve the blocks now so concurrent writers never hit ENOSPC halfway through.
+    if (size > 0) {
+        const int rc = posix_fallocate(fd, 0, static_cast<off_t>(size));
+        if (rc != 0 && rc != EOPNOTSUPP && rc != EINVAL) {
+            std::cerr << "Error: Cannot preallocate output file: " << filename << " (" << std::strerror(rc) << ")" << std::endl;
+            ::close(fd);
+            return false;
+        }
+    }
+#endif
+    fd_ = fd;
+    return true;
+}
+
+void PositionalOutputFile::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+bool PositionalOutputFile::writeAt(uint64_t offset, const char* data, size_t len) const {
+    offset += origin_;
+    while (len > 0) {
+        const ssize_t written = pwrite(fd_, data, len, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (written == 0) return false;
+        data += written;
+        len -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+bool PositionalOutputFile::sync() const {
+#if defined(__APPLE__)
+    return fsync(fd_) == 0;
+#else
+    return fdatasync(fd_) == 0;
+#endif
+}
+
+#endif
+
+}
@@ -0,0 +1,311 @@
+#include "packed_format.hpp"
+#include "mapped_file.hpp"
+#include "record_solver.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SUDOKU_PACKED_SSE2 1
+#else
+    #define SUDOKU_PACKED_SSE2 0
+#endif
+
+namespace SudokuApp {
+
+namespace {
+
+    const char PACKED_MAGIC[8] = {'S', 'U', 'D', 'O', 'K', 'U', 'P', 'K'};
+    constexpr uint32_t FNV_OFFSET = 2166136261u;
+    constexpr uint32_t FNV_PRIME = 16777619u;
+
+    // Output of the converters is handed to the stream in pieces of this size.
+    constexpr size_t WRITE_BUFFER = 1 << 20;
+
+    uint32_t fnvUpdate(uint32_t hash, const uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) hash = (hash ^ data[i]) * FNV_PRIME;
+        return hash;
+    }
+
+    /**
+     * @brief Expands a record into 96 cell values plus `base` (81 real cells, then padding).
+     * @return false if one of the 81 cells is above 9.
+     */
+    bool expand(const uint8_t* packed, uint8_t (&cells)[96], uint8_t base) {
+        // The record is copied first: loading 48 bytes straight from a mapping could run past its end.
+        alignas(16) uint8_t padded[48] = {};
+        std::memcpy(padded, packed, PACKED_CELLS_SIZE);
+#if SUDOKU_PACKED_SSE2
+        const __m128i lowNibble = _mm_set1_epi8(0x0F);
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i offset = _mm_set1_epi8(static_cast<char>(base));
+        __m128i bad = _mm_setzero_si128();
+        for (int k = 0; k < 3; ++k) {
+            const __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(padded + 16 * k));
+            const __m128i lo = _mm_and_si128(bytes, lowNibble);
+            const __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), lowNibble);
+            const __m128i first = _mm_unpacklo_epi8(lo, hi);
+            const __m128i second = _mm_unpackhi_epi8(lo, hi);
+            bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmpgt_epi8(first, nine), _mm_cmpgt_epi8(second, nine)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cells + 32 * k), _mm_add_epi8(first, offset));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cells + 32 * k + 16), _mm_add_epi8(second, offset));
+        }
+        // Cells 81-95 come from the zero padding (and the spare nibble, which must be 0 too).
+        return _mm_movemask_epi8(bad) == 0;
+#else
+        bool ok = true;
+        for (size_t k = 0; k < 48; ++k) {
+            const uint8_t lo = padded[k] & 0x0F;
+            const uint8_t hi = padded[k] >> 4;
+            ok &= lo <= 9 && hi <= 9;
+            cells[2 * k] = static_cast<uint8_t>(lo + base);
+            cells[2 * k + 1] = static_cast<uint8_t>(hi + base);
+        }
+        return ok;
+#endif
+    }
+
+    bool writeBuffer(std::ofstream& out, std::string& buffer) {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+        return static_cast<bool>(out);
+    }
+
+}
+
+PackedHeader makePackedHeader(uint64_t records, uint16_t flags, uint32_t blockRecords) {
+    PackedHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PACKED_MAGIC, sizeof(PACKED_MAGIC));
+    header.version = PACKED_VERSION;
+    header.flags = flags;
+    header.recordSize = static_cast<uint32_t>((flags & PACKED_HAS_STATUS) ? PACKED_STATUS_RECORD_SIZE : PACKED_CELLS_SIZE);
+    header.recordCount = records;
+    header.blockRecords = std::max(1u, blockRecords);
+    header.blockCount = static_cast<uint32_t>((records + header.blockRecords - 1) / header.blockRecords);
+    header.indexOffset = sizeof(PackedHeader) + records * header.recordSize;
+    return header;
+}
+
+uint64_t packedFileSize(const PackedHeader& header) {
+    return header.indexOffset + uint64_t(header.blockCount) * sizeof(PackedBlock);
+}
+
+bool hasPackedMagic(const char* data, uint64_t size) {
+    return size >= sizeof(PACKED_MAGIC) && std::memcmp(data, PACKED_MAGIC, sizeof(PACKED_MAGIC)) == 0;
+}
+
+bool readPackedHeader(const char* data, uint64_t size, PackedHeader& header) {
+    if (!hasPackedMagic(data, size) || size < sizeof(PackedHeader)) {
+        std::cerr << "Error: Not a packed puzzle file (bad magic or truncated header)." << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != PACKED_VERSION) {
+        std::cerr << "Error: Unsupported packed file version " << header.version << "." << std::endl;
+        return false;
+    }
+    const PackedHeader expected = makePackedHeader(std::min<uint64_t>(header.recordCount, size / PACKED_CELLS_SIZE),
+                                                   header.flags & PACKED_HAS_STATUS, header.blockRecords);
+    if (header.blockRecords == 0 || header.recordCount != expected.recordCount || header.recordSize != expected.recordSize
+        || header.blockCount != expected.blockCount || header.indexOffset != expected.indexOffset || packedFileSize(header) != size) {
+        std::cerr << "Error: Packed file is truncated or its header is inconsistent." << std::endl;
+        return false;
+    }
+    for (uint32_t b = 0; b < header.blockCount; ++b) {
+        PackedBlock block;
+        std::memcpy(&block, data + header.indexOffset + uint64_t(b) * sizeof(PackedBlock), sizeof(block));
+        const uint64_t first = uint64_t(b) * header.blockRecords;
+        if (block.offset != sizeof(PackedHeader) + first * header.recordSize
+            || block.records != std::min<uint64_t>(header.blockRecords, header.recordCount - first)) {
+            std::cerr << "Error: Packed file block index is corrupt at block " << b << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool verifyPackedBlocks(const char* data, const PackedHeader& header) {
+    for (uint32_t b = 0; b < header.blockCount; ++b) {
+        PackedBlock block;
+        std::memcpy(&block, data + header.indexOffset + uint64_t(b) * sizeof(PackedBlock), sizeof(block));
+        const uint8_t* records = reinterpret_cast<const uint8_t*>(data + block.offset);
+        if (blockChecksum(records, size_t(block.records) * header.recordSize) != block.checksum) {
+            std::cerr << "Error: Packed file block " << b << " fails its checksum." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void packCells(const char* puzzle, uint8_t* packed) {
+    auto cell = [&](size_t i) -> uint8_t {
+        const char c = puzzle[i];
+        return c >= '1' && c <= '9' ? static_cast<uint8_t>(c - '0') : 0;
+    };
+    for (size_t k = 0; k < PACKED_CELLS_SIZE - 1; ++k) packed[k] = static_cast<uint8_t>(cell(2 * k) | (cell(2 * k + 1) << 4));
+    packed[PACKED_CELLS_SIZE - 1] = cell(PUZZLE_SIZE - 1);
+}
+
+void markMalformed(uint8_t* packed) {
+    std::memset(packed, 0xFF, PACKED_CELLS_SIZE);
+}
+
+bool unpackCells(const uint8_t* packed, uint8_t* cells) {
+    uint8_t expanded[96];
+    const bool ok = expand(packed, expanded, 0);
+    std::memcpy(cells, expanded, PUZZLE_SIZE);
+    return ok;
+}
+
+bool unpackText(const uint8_t* packed, char* text) {
+    uint8_t expanded[96];
+    const bool ok = expand(packed, expanded, '0');
+    std::memcpy(text, expanded, PUZZLE_SIZE);
+    return ok;
+}
+
+uint32_t blockChecksum(const uint8_t* data, size_t len) {
+    return fnvUpdate(FNV_OFFSET, data, len);
+}
+
+bool finishPackedFile(const std::string& filename, const PackedHeader& header) {
+    std::vector<PackedBlock> index(header.blockCount);
+    {
+        MappedFile file;
+        if (!file.open(filename)) return false;
+        if (file.size() != packedFileSize(header)) {
+            std::cerr << "Error: Packed output has the wrong size: " << filename << std::endl;
+            return false;
+        }
+        for (uint32_t b = 0; b < header.blockCount; ++b) {
+            const uint64_t first = uint64_t(b) * header.blockRecords;
+            index[b].offset = sizeof(PackedHeader) + first * header.recordSize;
+            index[b].records = static_cast<uint32_t>(std::min<uint64_t>(header.blockRecords, header.recordCount - first));
+            index[b].checksum = blockChecksum(reinterpret_cast<const uint8_t*>(file.data() + index[b].offset),
+                                              size_t(index[b].records) * header.recordSize);
+        }
+    }
+    std::fstream out(filename, std::ios::in | std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.seekp(static_cast<std::streamoff>(header.indexOffset));
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(PackedBlock)));
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Failed writing the packed header and index: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool packTextFile(const std::string& inputFilename, const std::string& outputFilename, uint32_t blockRecords) {
+    MappedFile input;
+    if (!input.open(inputFilename)) return false;
+    std::ofstream out(outputFilename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Cannot open output file for writing: " << outputFilename << std::endl;
+        return false;
+    }
+    blockRecords = std::max(1u, blockRecords);
+
+    // The header is written last, once the record count is known.
+    const PackedHeader placeholder{};
+    out.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+
+    std::vector<PackedBlock> index;
+    std::string buffer;
+    buffer.reserve(WRITE_BUFFER + PACKED_CELLS_SIZE);
+    uint64_t records = 0;
+    uint32_t checksum = FNV_OFFSET;
+    const char* const data = input.data();
+    const uint64_t size = input.size();
+    uint64_t position = 0;
+    while (position < size) {
+        const char* line = data + position;
+        const char* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(size - position)));
+        const size_t len = newline ? static_cast<size_t>(newline - line) : static_cast<size_t>(size - position);
+        position += len + 1;
+
+        char scratch[PUZZLE_SIZE];
+        uint8_t packed[PACKED_CELLS_SIZE];
+        const char* puzzle = compactRecord(line, len, scratch);
+        if (puzzle != nullptr) packCells(puzzle, packed);
+        else markMalformed(packed);
+
+        if (records % blockRecords == 0) {
+            if (!index.empty()) index.back().checksum = checksum;
+            index.push_back({sizeof(PackedHeader) + records * PACKED_CELLS_SIZE, 0, 0});
+            checksum = FNV_OFFSET;
+        }
+        checksum = fnvUpdate(checksum, packed, sizeof(packed));
+        index.back().records++;
+        records++;
+        buffer.append(reinterpret_cast<const char*>(packed), sizeof(packed));
+        if (buffer.size() >= WRITE_BUFFER && !writeBuffer(out, buffer)) break;
+    }
+    if (!index.empty()) index.back().checksum = checksum;
+    writeBuffer(out, buffer);
+
+    const PackedHeader header = makePackedHeader(records, 0, blockRecords);
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(PackedBlock)));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Failed writing packed file: " << outputFilename << std::endl;
+        std::remove(outputFilename.c_str());
+        return false;
+    }
+    std::cout << "Packed " << records << " records into " << outputFilename << " (" << packedFileSize(header) << " bytes)." << std::endl;
+    return true;
+}
+
+bool unpackTextFile(const std::string& inputFilename, const std::string& outputFilename, const RecordMarkers& markers) {
+    MappedFile input;
+    PackedHeader header;
+    if (!input.open(inputFilename) || !readPackedHeader(input.data(), input.size(), header)
+        || !verifyPackedBlocks(input.data(), header)) {
+        return false;
+    }
+    std::ofstream out(outputFilename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Cannot open output file for writing: " << outputFilename << std::endl;
+        return false;
+    }
+
+    const bool hasStatus = (header.flags & PACKED_HAS_STATUS) != 0;
+    std::string buffer;
+    buffer.reserve(WRITE_BUFFER + OUTPUT_RECORD_SIZE);
+    char line[OUTPUT_RECORD_SIZE];
+    line[PUZZLE_SIZE] = '\n';
+    bool ok = true;
+    for (uint64_t i = 0; i < header.recordCount && ok; ++i) {
+        const uint8_t* record = reinterpret_cast<const uint8_t*>(input.data() + sizeof(PackedHeader) + i * header.recordSize);
+        const uint8_t status = hasStatus ? record[PACKED_CELLS_SIZE] : static_cast<uint8_t>(RecordStatus::Solved);
+        if (status > static_cast<uint8_t>(RecordStatus::Aborted)) {
+            std::cerr << "Error: Record " << i << " has an unknown status byte " << int(status) << "." << std::endl;
+            ok = false;
+            break;
+        }
+        if (!unpackText(record, line)) std::memcpy(line, markers.invalid.data(), PUZZLE_SIZE);
+        else if (status != static_cast<uint8_t>(RecordStatus::Solved)) std::memcpy(line, markers.forStatus(static_cast<RecordStatus>(status)), PUZZLE_SIZE);
+        buffer.append(line, OUTPUT_RECORD_SIZE);
+        if (buffer.size() >= WRITE_BUFFER) ok = writeBuffer(out, buffer);
+    }
+    if (ok) ok = writeBuffer(out, buffer);
+    out.close();
+    if (!ok || !out) {
+        std::cerr << "Error: Failed writing text file: " << outputFilename << std::endl;
+        std::remove(outputFilename.c_str());
+        return false;
+    }
+    std::cout << "Unpacked " << header.recordCount << " records into " << outputFilename << "." << std::endl;
+    return true;
+}
+
+}
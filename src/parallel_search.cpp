@@ -0,0 +1,179 @@
+#include "parallel_search.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace SudokuApp {
+
+ParallelSearch::ParallelSearch(ThreadPool& pool)
+    : pool(pool),
+      queues(new Queue[pool.size()])
+{
+}
+
+SolveResult ParallelSearch::solve(SudokuSolver& root, const SearchBudget& budget, char* solution) {
+    bool aborted = false;
+    if (search(root, 1, budget, solution, aborted) > 0) return SolveResult::Solved;
+    return aborted ? SolveResult::Aborted : SolveResult::Unsolvable;
+}
+
+uint64_t ParallelSearch::countSolutions(SudokuSolver& root, uint64_t limit, const SearchBudget& budget, bool& aborted) {
+    aborted = false;
+    if (limit == 0) return 0;
+    char solution[SudokuSolver::CELLS];
+    return search(root, limit, budget, solution, aborted);
+}
+
+uint64_t ParallelSearch::search(SudokuSolver& root, uint64_t limit, const SearchBudget& budget, char* solution, bool& aborted) {
+    // A short sequential search first: splitting costs a few copies of the solver and a round
+    // trip through the pool, which only pays off for puzzles that need real search.
+    const uint64_t probeNodes = budget.maxNodes != 0 ? std::min(budget.maxNodes, SEQUENTIAL_NODES) : SEQUENTIAL_NODES;
+    if (budget.maxMillis != 0) deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget.maxMillis);
+    auto task = std::make_unique<Task>();
+    task->state = root;
+    root.setBudget({probeNodes, budget.maxMillis, budget.cancel});
+    const uint64_t count = limit == 1 ? (root.solve() == SolveResult::Solved ? 1 : 0) : root.countSolutions(limit);
+    if (!root.budgetExhausted() || (budget.maxNodes != 0 && budget.maxNodes <= SEQUENTIAL_NODES)) {
+        if (count > 0) std::memcpy(solution, root.getSolution(), SudokuSolver::CELLS);
+        aborted = root.budgetExhausted();
+        return count;
+    }
+
+    // The probe's nodes count against the budget, its solutions do not: the split search
+    // starts over from the same root.
+    this->limit = limit;
+    this->budget = budget;
+    stop.store(false);
+    budgetHit.store(false);
+    solutions.store(0);
+    nodesUsed.store(root.nodesVisited());
+    haveSolution = false;
+    solutionOut = solution;
+    outstanding.store(1);
+    queued.store(1);
+    queues[0].tasks.push_back(std::move(task));
+
+    pool.run([this](unsigned worker) { work(worker); });
+
+    // A stopped search leaves subproblems behind.
+    for (unsigned i = 0; i < pool.size(); ++i) queues[i].tasks.clear();
+    const uint64_t total = std::min(solutions.load(), limit);
+    aborted = budgetHit.load() && total < limit;
+    return total;
+}
+
+void ParallelSearch::work(unsigned worker) {
+    for (;;) {
+        std::unique_ptr<Task> task = take(worker);
+        if (!task) {
+            if (stop.load(std::memory_order_relaxed) || outstanding.load() == 0) return;
+            std::this_thread::yield();
+            continue;
+        }
+        if (!stop.load(std::memory_order_relaxed)) process(worker, *task);
+        outstanding.fetch_sub(1);
+    }
+}
+
+// Own queue from the back (newest, deepest), other queues from the front (oldest, largest).
+std::unique_ptr<ParallelSearch::Task> ParallelSearch::take(unsigned worker) {
+    const unsigned workers = pool.size();
+    for (unsigned k = 0; k < workers; ++k) {
+        Queue& queue = queues[(worker + k) % workers];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        std::unique_ptr<Task> task;
+        if (k == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+    return nullptr;
+}
+
+void ParallelSearch::push(unsigned worker, std::unique_ptr<Task> task) {
+    Queue& queue = queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+    queued.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ParallelSearch::process(unsigned worker, Task& task) {
+    SudokuSolver& state = task.state;
+    if (task.depth < MAX_SPLIT_DEPTH && queued.load(std::memory_order_relaxed) < uint64_t(SPLIT_TASKS_PER_WORKER) * pool.size()) {
+        const int cell = state.branchCell();
+        if (cell < 0) {
+            if (state.complete()) found(1, state.getSolution());
+            return;
+        }
+        // Highest digit first, so the owner's next pop takes the lowest: the order the
+        // sequential search would try them in.
+        const SudokuSolver::Mask candidates = state.cellCandidates(cell);
+        for (int num = static_cast<int>(SudokuSolver::DIGITS); num >= 1; --num) {
+            if (!(candidates & (1u << num))) continue;
+            auto child = std::make_unique<Task>();
+            child->state = state;
+            child->depth = task.depth + 1;
+            child->state.assume(cell, num);
+            outstanding.fetch_add(1);
+            push(worker, std::move(child));
+        }
+        return;
+    }
+
+    const SearchBudget subtask = budgetFor();
+    if (budgetHit.load(std::memory_order_relaxed)) return;
+    state.setBudget(subtask);
+    if (limit == 1) {
+        if (state.solve() == SolveResult::Solved) found(1, state.getSolution());
+    } else {
+        const uint64_t have = solutions.load();
+        if (have >= limit) return;
+        const uint64_t count = state.countSolutions(limit - have);
+        if (count > 0) found(count, state.getSolution());
+    }
+    nodesUsed.fetch_add(state.nodesVisited(), std::memory_order_relaxed);
+    // Cancelled searches stop the same way; they only happen once the limit is reached.
+    if (state.budgetExhausted() && solutions.load() < limit) {
+        budgetHit.store(true);
+        stop.store(true);
+    }
+}
+
+void ParallelSearch::found(uint64_t count, const char* grid) {
+    {
+        std::lock_guard<std::mutex> lock(solutionMutex);
+        if (!haveSolution) {
+            std::memcpy(solutionOut, grid, SudokuSolver::CELLS);
+            haveSolution = true;
+        }
+    }
+    if (solutions.fetch_add(count) + count >= limit) stop.store(true);
+}
+
+// What is left of the caller's budget, plus the shared cancel flag. A spent budget marks the
+// search as out of budget right away.
+SearchBudget ParallelSearch::budgetFor() {
+    SearchBudget subtask;
+    subtask.cancel = &stop;
+    if (budget.maxNodes != 0) {
+        const uint64_t used = nodesUsed.load(std::memory_order_relaxed);
+        if (used >= budget.maxNodes) budgetHit.store(true);
+        else subtask.maxNodes = budget.maxNodes - used;
+    }
+    if (budget.maxMillis != 0) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) budgetHit.store(true);
+        else subtask.maxMillis = static_cast<uint32_t>(left);
+    }
+    if (budgetHit.load(std::memory_order_relaxed)) stop.store(true);
+    return subtask;
+}
+
+}
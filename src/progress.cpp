@@ -0,0 +1,121 @@
+#include "progress.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace SudokuApp {
+
+namespace {
+
+    /** @brief "1h02m03s", "4m05s" or "6s". */
+    std::string formatDuration(double seconds) {
+        const uint64_t total = static_cast<uint64_t>(seconds + 0.5);
+        std::ostringstream out;
+        out << std::setfill('0');
+        if (total >= 3600) out << total / 3600 << "h" << std::setw(2) << total / 60 % 60 << "m" << std::setw(2) << total % 60 << "s";
+        else if (total >= 60) out << total / 60 << "m" << std::setw(2) << total % 60 << "s";
+        else out << total << "s";
+        return out.str();
+    }
+
+}
+
+uint64_t ProgressCounters::processed() const {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) sum += slots[i].processed.load(std::memory_order_relaxed);
+    return sum;
+}
+
+uint64_t ProgressCounters::solved() const {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) sum += slots[i].solved.load(std::memory_order_relaxed);
+    return sum;
+}
+
+ProgressReporter::ProgressReporter(const ProgressCounters& counters, uint64_t total, const ProgressOptions& options)
+    : counters(counters),
+      total(total),
+      options(options),
+      start(std::chrono::steady_clock::now()),
+      lastTime(start)
+{
+    if (options.enabled()) thread = std::thread(&ProgressReporter::run, this);
+}
+
+ProgressReporter::~ProgressReporter() {
+    stop();
+}
+
+void ProgressReporter::stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+    if (!options.statusFile.empty()) report(true);
+}
+
+void ProgressReporter::run() {
+    const auto interval = std::chrono::duration<double>(options.intervalSeconds);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+        lock.unlock();
+        report(false);
+        lock.lock();
+    }
+}
+
+void ProgressReporter::report(bool done) {
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t processed = counters.processed();
+    const uint64_t solved = counters.solved();
+    const double elapsed = std::chrono::duration<double>(now - start).count();
+    const double sinceLast = std::chrono::duration<double>(now - lastTime).count();
+    const double rate = sinceLast > 0 ? static_cast<double>(processed - lastProcessed) / sinceLast : 0.0;
+    const double average = elapsed > 0 ? static_cast<double>(processed) / elapsed : 0.0;
+    const bool known = total != 0;
+    const double percent = known ? 100.0 * static_cast<double>(processed) / static_cast<double>(total) : 0.0;
+    const double eta = known && average > 0 && processed < total ? static_cast<double>(total - processed) / average : 0.0;
+    lastTime = now;
+    lastProcessed = processed;
+
+    if (options.statusFile.empty()) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "Progress: " << processed;
+        if (known) line << "/" << total << " records (" << percent << "%)";
+        else line << " records";
+        line << ", " << solved << " solved, " << static_cast<uint64_t>(rate) << " puzzles/s, elapsed " << formatDuration(elapsed);
+        if (known) line << ", ETA " << formatDuration(eta);
+        std::cerr << line.str() << std::endl;
+        return;
+    }
+
+    const std::string temporary = options.statusFile + ".tmp";
+    std::ofstream out(temporary, std::ios::trunc);
+    out << std::fixed << std::setprecision(3)
+        << "{ \"records\": " << processed
+        << ", \"total\": " << total
+        << ", \"solved\": " << solved
+        << ", \"percent\": " << percent
+        << ", \"puzzles_per_second\": " << rate
+        << ", \"elapsed_seconds\": " << elapsed
+        << ", \"eta_seconds\": " << eta
+        << ", \"done\": " << (done ? "true" : "false") << " }\n";
+    out.close();
+    if (!out) {
+        std::remove(temporary.c_str());
+        return;
+    }
+    // POSIX rename replaces the old file in one step; Windows needs it gone first.
+    if (std::rename(temporary.c_str(), options.statusFile.c_str()) != 0) {
+        std::remove(options.statusFile.c_str());
+        std::rename(temporary.c_str(), options.statusFile.c_str());
+    }
+}
+
+}
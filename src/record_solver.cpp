@@ -0,0 +1,300 @@
+#include "record_solver.hpp"
+#include "parallel_search.hpp"
+#include "solve_cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace SudokuApp {
+
+namespace {
+
+    /**
+     * @brief True if any of the `len` bytes is below 0x21 (space, tab, CR, other control chars).
+     * Word-at-a-time check; a hit only means the record must go through the slow path.
+     */
+    inline bool hasSpaceOrControl(const char* data, size_t len) {
+        constexpr uint64_t ONES = 0x0101010101010101ull;
+        constexpr uint64_t HIGHS = 0x8080808080808080ull;
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            if ((word - ONES * 0x21) & ~word & HIGHS) return true;
+        }
+        for (; i < len; ++i) {
+            if (static_cast<unsigned char>(data[i]) < 0x21) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Copies the non-whitespace characters of a malformed record into `cleaned`.
+     * @return The number of cells copied, or PUZZLE_SIZE + 1 if there are too many.
+     */
+    size_t stripWhitespace(const char* data, size_t len, char (&cleaned)[PUZZLE_SIZE]) {
+        size_t count = 0;
+        for (size_t i = 0; i < len; ++i) {
+            const unsigned char c = static_cast<unsigned char>(data[i]);
+            if (std::isspace(c)) continue;
+            if (count == PUZZLE_SIZE) return PUZZLE_SIZE + 1;
+            cleaned[count++] = static_cast<char>(c);
+        }
+        return count;
+    }
+
+    // Count mode: a digit would read as a count, so markers starting with one fall back to 'X' / '?'.
+    char verdictMarker(char marker, char fallback) {
+        return std::isdigit(static_cast<unsigned char>(marker)) ? fallback : marker;
+    }
+
+}
+
+RecordMarkers::RecordMarkers() {
+    invalid.fill('X');
+    unsolvable.fill('0');
+    aborted.fill('?');
+}
+
+bool RecordMarkers::parse(const std::string& spec, std::array<char, PUZZLE_SIZE>& marker) {
+    if (spec.find('\n') != std::string::npos) return false;
+    if (spec.size() == 1) {
+        marker.fill(spec[0]);
+        return true;
+    }
+    if (spec.size() != PUZZLE_SIZE) return false;
+    if (std::all_of(spec.begin(), spec.end(), [](char c) { return c >= '1' && c <= '9'; })) return false;
+    std::copy(spec.begin(), spec.end(), marker.begin());
+    return true;
+}
+
+const char* compactRecord(const char* line, size_t len, char (&scratch)[PUZZLE_SIZE]) {
+    if (len == PUZZLE_SIZE && !hasSpaceOrControl(line, len)) return line;
+    return stripWhitespace(line, len, scratch) == PUZZLE_SIZE ? scratch : nullptr;
+}
+
+RecordSolver::RecordSolver(const RecordMarkers& markers, const SolveOptions& options, WorkerStats& stats,
+                           WorkerProgress& progress)
+    : markers(markers),
+      options(options),
+      stats(stats),
+      progress(progress),
+      recordBytes(options.countLimit ? countRecordSize(options.countLimit)
+                  : options.output == OutputFormat::Packed ? PACKED_STATUS_RECORD_SIZE : OUTPUT_RECORD_SIZE),
+      invalidVerdict(verdictMarker(markers.invalid[0], 'X')),
+      abortedVerdict(verdictMarker(markers.aborted[0], '?'))
+{
+    solver.setBudget(options.budget);
+    batchSolver.setBudget(options.budget);
+    dlxSolver.setBudget(options.budget);
+    splitSearch.search = options.parallel;
+    splitSearch.solver = &solver;
+    splitSearch.setBudget(options.budget);
+    for (size_t lane = 0; lane < LANES; ++lane) stagedPuzzles[lane] = staged[lane];
+}
+
+void RecordSolver::process(const char* puzzle, std::string& out) {
+    if (options.countLimit != 0) {
+        countOne(puzzle, out);
+        return;
+    }
+
+    if (options.engine == SolverEngine::Batch) {
+        if (puzzle == nullptr) {
+            stagedKind[stagedCount++] = Staged::Malformed;
+        } else if (options.cache != nullptr
+                   && lookupCached(puzzle, laneForms[lanesUsed], stagedStatus[stagedCount], stagedCells[stagedCount])) {
+            stagedKind[stagedCount++] = Staged::Cached;
+        } else {
+            std::memcpy(staged[lanesUsed++], puzzle, PUZZLE_SIZE);
+            stagedKind[stagedCount++] = Staged::Lane;
+        }
+        if (stagedCount == LANES) solveStaged(out);
+        return;
+    }
+
+    if (options.engine == SolverEngine::Dlx) solveOne(dlxSolver, puzzle, out);
+    else if (options.parallel != nullptr) solveOne(splitSearch, puzzle, out);
+    else solveOne(solver, puzzle, out);
+}
+
+void RecordSolver::processPacked(const uint8_t* packed, std::string& out) {
+    char text[PUZZLE_SIZE];
+    if (!unpackText(packed, text)) {
+        process(nullptr, out);
+        return;
+    }
+    if (options.countLimit != 0 || options.engine != SolverEngine::Scalar || options.cache != nullptr || options.parallel != nullptr) {
+        process(text, out);
+        return;
+    }
+    RecordStatus status = RecordStatus::Invalid;
+    {
+        StatsTimer timer(stats.solveSeconds, &stats.solveLatency);
+        if (solver.initializePacked(packed)) status = toRecordStatus(solver.solve());
+    }
+    SUDOKU_STAT(if (status != RecordStatus::Invalid) stats.search += solver.searchStats());
+    emit(status, solver.getSolution(), text, out);
+}
+
+void RecordSolver::finish(std::string& out) {
+    solveStaged(out);
+}
+
+// `puzzle` is null for malformed lines. Aborted records are kept for the retry pass.
+void RecordSolver::emit(RecordStatus status, const char* solution, const char* puzzle, std::string& out) {
+    if (status == RecordStatus::Aborted && options.retryAborted) {
+        deferred.push_back({nextRecord, {}});
+        std::memcpy(deferred.back().puzzle, puzzle, PUZZLE_SIZE);
+    }
+    if (status == RecordStatus::Solved) progress.addSolved();
+    char record[OUTPUT_RECORD_SIZE];
+    formatRecord(status, solution, puzzle, record);
+    out.append(record, recordBytes);
+    nextRecord++;
+}
+
+// Text records hold the solution or the status marker; packed ones the solution or the puzzle
+// as given (malformed lines: the malformed pattern), followed by the status byte.
+void RecordSolver::formatRecord(RecordStatus status, const char* solution, const char* puzzle, char* record) const {
+    if (options.output == OutputFormat::Packed) {
+        uint8_t* packed = reinterpret_cast<uint8_t*>(record);
+        const char* cells = status == RecordStatus::Solved ? solution : puzzle;
+        if (cells != nullptr) packCells(cells, packed);
+        else markMalformed(packed);
+        packed[PACKED_CELLS_SIZE] = static_cast<uint8_t>(status);
+        return;
+    }
+    std::memcpy(record, status == RecordStatus::Solved ? solution : markers.forStatus(status), PUZZLE_SIZE);
+    record[PUZZLE_SIZE] = '\n';
+}
+
+void RecordSolver::solveStaged(std::string& out) {
+    if (stagedCount == 0) return;
+    {
+        StatsTimer timer(stats.solveSeconds, &stats.solveLatency, lanesUsed);
+        batchSolver.solve(stagedPuzzles, lanesUsed);
+    }
+    SUDOKU_STAT(stats.search += batchSolver.searchStats());
+    size_t lane = 0;
+    for (size_t k = 0; k < stagedCount; ++k) {
+        if (stagedKind[k] == Staged::Malformed) {
+            emit(RecordStatus::Invalid, nullptr, nullptr, out);
+            continue;
+        }
+        if (stagedKind[k] == Staged::Cached) {
+            emit(stagedStatus[k], stagedCells[k], stagedCells[k], out);
+            continue;
+        }
+        const RecordStatus status = !batchSolver.valid(lane) ? RecordStatus::Invalid
+                                  : batchSolver.aborted(lane) ? RecordStatus::Aborted
+                                  : !batchSolver.solved(lane) ? RecordStatus::Unsolvable : RecordStatus::Solved;
+        const char* solution = status == RecordStatus::Solved ? batchSolver.solution(lane) : nullptr;
+        if (options.cache != nullptr) options.cache->insert(laneForms[lane], status, solution);
+        emit(status, solution, staged[lane], out);
+        lane++;
+    }
+    stagedCount = 0;
+    lanesUsed = 0;
+}
+
+template <typename Backend>
+void RecordSolver::solveOne(Backend& backend, const char* puzzle, std::string& out) {
+    RecordStatus status = RecordStatus::Invalid;
+    if (puzzle != nullptr) {
+        if (options.cache != nullptr && lookupCached(puzzle, form, status, cachedCells)) {
+            emit(status, cachedCells, puzzle, out);
+            return;
+        }
+        {
+            StatsTimer timer(stats.solveSeconds, &stats.solveLatency);
+            status = solveRecord(backend, puzzle);
+        }
+        SUDOKU_STAT(if (status != RecordStatus::Invalid) stats.search += backend.searchStats());
+        if (options.cache != nullptr) options.cache->insert(form, status, backend.getSolution());
+    }
+    emit(status, backend.getSolution(), puzzle, out);
+}
+
+SolveResult RecordSolver::SplitSearch::solve() {
+    return search->solve(*solver, budget, solution);
+}
+
+bool RecordSolver::lookupCached(const char* puzzle, CanonicalForm& form, RecordStatus& status, char* cells) {
+    canonicalize(puzzle, form);
+    if (!options.cache->lookup(form, status, cells)) return false;
+    if (status != RecordStatus::Solved) std::memcpy(cells, puzzle, PUZZLE_SIZE);
+    return true;
+}
+
+// Count mode: the verdict is the solution count, zero-padded to the record width.
+void RecordSolver::countOne(const char* puzzle, std::string& out) {
+    const size_t width = recordBytes - 1;
+    if (puzzle != nullptr && solver.initialize(puzzle, PUZZLE_SIZE)) {
+        uint64_t count;
+        bool aborted = false;
+        {
+            StatsTimer timer(stats.solveSeconds, &stats.solveLatency);
+            if (options.parallel != nullptr) {
+                count = options.parallel->countSolutions(solver, options.countLimit, options.budget, aborted);
+            } else {
+                count = solver.countSolutions(options.countLimit);
+                aborted = solver.budgetExhausted();
+            }
+        }
+        SUDOKU_STAT(stats.search += solver.searchStats());
+        if (count > 0) progress.addSolved();
+        if (aborted) {
+            out.append(width, abortedVerdict);
+        } else {
+            char digits[24];
+            std::snprintf(digits, sizeof(digits), "%0*llu", static_cast<int>(width), static_cast<unsigned long long>(count));
+            out.append(digits, width);
+        }
+    } else {
+        out.append(width, invalidVerdict);
+    }
+    out.push_back('\n');
+    nextRecord++;
+}
+
+// The retry pass runs the scalar solver for the batch engine too: a puzzle that needs a
+// bigger budget is past what the vector kernel finishes anyway.
+bool RecordSolver::retryDeferred(const std::function<bool(uint64_t record, const char* data)>& write) {
+    solver.setBudget(options.retryBudget);
+    dlxSolver.setBudget(options.retryBudget);
+    splitSearch.setBudget(options.retryBudget);
+    char record[OUTPUT_RECORD_SIZE];
+    bool ok = true;
+    for (const DeferredRecord& entry : deferred) {
+        const char* solution = nullptr;
+        RecordStatus status;
+        {
+            StatsTimer timer(stats.solveSeconds);
+            if (options.engine == SolverEngine::Dlx) { status = solveRecord(dlxSolver, entry.puzzle); solution = dlxSolver.getSolution(); }
+            else if (options.parallel != nullptr) { status = solveRecord(splitSearch, entry.puzzle); solution = splitSearch.getSolution(); }
+            else { status = solveRecord(solver, entry.puzzle); solution = solver.getSolution(); }
+        }
+        if (status == RecordStatus::Aborted) continue;
+        if (options.cache != nullptr) {
+            canonicalize(entry.puzzle, form);
+            options.cache->insert(form, status, solution);
+        }
+
+        formatRecord(status, solution, entry.puzzle, record);
+        if (status == RecordStatus::Solved) progress.addSolved();
+        if (!write(entry.record, record)) {
+            ok = false;
+            break;
+        }
+    }
+    deferred.clear();
+    solver.setBudget(options.budget);
+    dlxSolver.setBudget(options.budget);
+    splitSearch.setBudget(options.budget);
+    return ok;
+}
+
+}
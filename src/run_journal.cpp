@@ -0,0 +1,269 @@
+#include "run_journal.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace SudokuApp {
+
+namespace {
+
+    const char JOURNAL_MAGIC[8] = {'S', 'U', 'D', 'O', 'K', 'U', 'J', 'L'};
+    constexpr uint32_t JOURNAL_VERSION = 1;
+
+    /** Journal files: this header, then one entry per finished chunk. */
+    struct JournalHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entrySize;
+        uint64_t fingerprint;
+        uint64_t chunkCount;
+    };
+
+    // splitmix64 finalizer: every bit of the input affects every bit of the check.
+    uint64_t mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+}
+
+uint64_t fingerprintBytes(uint64_t hash, const void* data, size_t len) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+RunJournal::~RunJournal() {
+    finish();
+    close();
+}
+
+RunJournal::Entry RunJournal::makeEntry(uint64_t chunk) const {
+    return {chunk, mix(fingerprint ^ mix(chunk))};
+}
+
+bool RunJournal::open(const std::string& filename, uint64_t runFingerprint, size_t chunkCount, bool resume) {
+    close();
+    path = filename;
+    fingerprint = runFingerprint;
+    done.assign(chunkCount, 0);
+    completedChunks = 0;
+
+    // Entries past a torn or foreign one are not trusted; appending resumes at `validBytes`.
+    uint64_t validBytes = 0;
+    if (resume) {
+        std::ifstream in(path, std::ios::binary);
+        JournalHeader header;
+        if (in && in.read(reinterpret_cast<char*>(&header), sizeof(header))
+            && std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 && header.version == JOURNAL_VERSION
+            && header.entrySize == sizeof(Entry) && header.fingerprint == fingerprint && header.chunkCount == chunkCount) {
+            validBytes = sizeof(header);
+            Entry entry;
+            while (in.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+                const Entry expected = makeEntry(entry.chunk);
+                if (entry.chunk >= chunkCount || entry.check != expected.check) break;
+                if (!done[entry.chunk]) completedChunks++;
+                done[entry.chunk] = 1;
+                validBytes += sizeof(entry);
+            }
+        }
+    }
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, validBytes != 0 ? OPEN_ALWAYS : CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: Cannot open checkpoint journal: " << path << std::endl;
+        return false;
+    }
+    handle_ = file;
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(validBytes);
+    if (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        std::cerr << "Error: Cannot open checkpoint journal: " << path << std::endl;
+        close();
+        return false;
+    }
+#else
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (validBytes != 0 ? 0 : O_TRUNC), 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open checkpoint journal: " << path << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    fd_ = fd;
+    if (ftruncate(fd, static_cast<off_t>(validBytes)) != 0 || lseek(fd, static_cast<off_t>(validBytes), SEEK_SET) < 0) {
+        std::cerr << "Error: Cannot open checkpoint journal: " << path << " (" << std::strerror(errno) << ")" << std::endl;
+        close();
+        return false;
+    }
+#endif
+
+    if (validBytes == 0) {
+        JournalHeader header{};
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header.version = JOURNAL_VERSION;
+        header.entrySize = sizeof(Entry);
+        header.fingerprint = fingerprint;
+        header.chunkCount = chunkCount;
+        bool written;
+#if defined(_WIN32)
+        DWORD count = 0;
+        written = WriteFile(static_cast<HANDLE>(handle_), &header, sizeof(header), &count, nullptr) && count == sizeof(header);
+#else
+        written = ::write(fd_, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+#endif
+        if (!written || !sync()) {
+            std::cerr << "Error: Cannot write checkpoint journal: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void RunJournal::start(const PositionalOutputFile& outputFile) {
+    output = &outputFile;
+    stopping = false;
+    failed = false;
+    committer = std::thread([this] { commitLoop(); });
+}
+
+void RunJournal::complete(size_t chunk) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(chunk);
+    }
+    wake.notify_one();
+}
+
+bool RunJournal::finish() {
+    if (committer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        committer.join();
+    }
+    return !failed;
+}
+
+void RunJournal::remove() {
+    finish();
+    close();
+    if (!path.empty()) std::remove(path.c_str());
+}
+
+// One group per round: whatever finished since the last one, at most every COMMIT_INTERVAL_MS.
+void RunJournal::commitLoop() {
+    std::vector<size_t> group;
+    std::vector<Entry> entries;
+    auto lastCommit = std::chrono::steady_clock::now() - std::chrono::milliseconds(COMMIT_INTERVAL_MS);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (!stopping) {
+                wake.wait_until(lock, lastCommit + std::chrono::milliseconds(COMMIT_INTERVAL_MS), [this] { return stopping; });
+            }
+            group.swap(pending);
+            if (group.empty() && stopping) return;
+        }
+        lastCommit = std::chrono::steady_clock::now();
+        if (failed) {
+            group.clear();
+            continue;
+        }
+        // The records first: an entry must never reach the disk before the chunk it vouches for.
+        if (!output->sync()) {
+            std::cerr << "Error: Cannot sync the output file for the checkpoint journal." << std::endl;
+            failed = true;
+            group.clear();
+            continue;
+        }
+        entries.clear();
+        for (size_t chunk : group) entries.push_back(makeEntry(chunk));
+        group.clear();
+        if (!append(entries) || !sync()) {
+            std::cerr << "Error: Cannot write checkpoint journal: " << path << std::endl;
+            failed = true;
+        }
+    }
+}
+
+#if defined(_WIN32)
+
+bool RunJournal::append(const std::vector<Entry>& entries) {
+    const char* data = reinterpret_cast<const char*>(entries.data());
+    size_t len = entries.size() * sizeof(Entry);
+    while (len > 0) {
+        const DWORD chunk = static_cast<DWORD>(len > 0x40000000u ? 0x40000000u : len);
+        DWORD written = 0;
+        if (!WriteFile(static_cast<HANDLE>(handle_), data, chunk, &written, nullptr) || written == 0) return false;
+        data += written;
+        len -= written;
+    }
+    return true;
+}
+
+bool RunJournal::sync() {
+    return FlushFileBuffers(static_cast<HANDLE>(handle_)) != 0;
+}
+
+void RunJournal::close() {
+    if (handle_ != nullptr) CloseHandle(static_cast<HANDLE>(handle_));
+    handle_ = nullptr;
+}
+
+#else
+
+bool RunJournal::append(const std::vector<Entry>& entries) {
+    const char* data = reinterpret_cast<const char*>(entries.data());
+    size_t len = entries.size() * sizeof(Entry);
+    while (len > 0) {
+        const ssize_t written = ::write(fd_, data, len);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (written == 0) return false;
+        data += written;
+        len -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool RunJournal::sync() {
+#if defined(__APPLE__)
+    return fsync(fd_) == 0;
+#else
+    return fdatasync(fd_) == 0;
+#endif
+}
+
+void RunJournal::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+#endif
+
+}
@@ -0,0 +1,710 @@
+#include "run_solver.hpp"
+#include "compressed_stream.hpp"
+#include "packed_format.hpp"
+#include "parallel_search.hpp"
+#include "run_journal.hpp"
+#include "thread_pool.hpp"
+#include "worker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SudokuApp {
+
+namespace {
+
+    /**
+     * @brief Counts the records of every chunk on the pool and assigns each chunk its first output slot.
+     *
+     * Uses the same chunk domains as the solve pass, so each input page is first read on the
+     * node that later solves it.
+     * @param totalRecords Receives the total number of records in the input.
+     * @return false if a chunk could not be counted (the error is printed to stderr).
+     */
+    bool countChunkRecords(const std::string& inputFilename,
+                               const MappedFile* mappedInput,
+                               uint64_t inputSize,
+                               ThreadPool& pool,
+                               const std::vector<unsigned>& domainWeights,
+                               const std::vector<size_t>& domains,
+                               std::vector<InputChunk>& chunks,
+                               uint64_t& totalRecords)
+    {
+        ChunkScheduler scheduler(chunks.size(), domainWeights);
+        std::atomic<bool> failed(false);
+        pool.run([&](unsigned worker) {
+            size_t i = 0;
+            while (!failed.load(std::memory_order_relaxed) && scheduler.claim(i, domains[worker])) {
+                const ByteRange range = chunks[i].range;
+                if (mappedInput != nullptr) {
+                    chunks[i].recordCount = countRecords(mappedInput->data(), inputSize, range);
+                    mappedInput->release(range.begin, range.end);
+                } else if (!countRecords(inputFilename, inputSize, range, chunks[i].recordCount)) {
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        });
+        if (failed.load()) return false;
+
+        totalRecords = 0;
+        for (auto& chunk : chunks) {
+            chunk.firstRecord = totalRecords;
+            totalRecords += chunk.recordCount;
+        }
+        return true;
+    }
+
+    bool startsWithPackedMagic(const std::string& filename) {
+        char magic[8] = {};
+        std::ifstream in(filename, std::ios::binary);
+        in.read(magic, sizeof(magic));
+        return hasPackedMagic(magic, static_cast<uint64_t>(in.gcount()));
+    }
+
+    /** @brief About `parts` chunks of whole records of a packed file; their counts are known up front. */
+    std::vector<InputChunk> packedChunks(const PackedHeader& header, uint64_t parts) {
+        std::vector<InputChunk> chunks;
+        parts = std::max<uint64_t>(1, std::min(parts, header.recordCount));
+        for (uint64_t i = 0; i < parts; ++i) {
+            InputChunk chunk;
+            chunk.firstRecord = header.recordCount * i / parts;
+            chunk.recordCount = header.recordCount * (i + 1) / parts - chunk.firstRecord;
+            if (chunk.recordCount == 0) continue;
+            chunk.range.begin = sizeof(PackedHeader) + chunk.firstRecord * header.recordSize;
+            chunk.range.end = chunk.range.begin + chunk.recordCount * header.recordSize;
+            chunks.push_back(chunk);
+        }
+        return chunks;
+    }
+
+    /**
+     * @brief Each worker's chunk domain (see `ChunkScheduler`); `weights` receives the workers per domain.
+     *
+     * The input is only split per NUMA node when every worker is pinned and the workers span
+     * several nodes: an unpinned thread may migrate, so the split would not keep pages local.
+     */
+    std::vector<size_t> chunkDomains(const ThreadPool& pool, const CpuTopology& topology, std::vector<unsigned>& weights) {
+        std::vector<size_t> domains(pool.size(), 0);
+        weights.assign(1, pool.size());
+        const std::vector<unsigned>& nodes = topology.nodes();
+        if (nodes.size() < 2) return domains;
+
+        std::vector<unsigned> perNode(nodes.size(), 0);
+        for (unsigned i = 0; i < pool.size(); ++i) {
+            if (!pool.pinned(i)) return std::vector<size_t>(pool.size(), 0);
+            domains[i] = static_cast<size_t>(std::find(nodes.begin(), nodes.end(), pool.cpu(i).node) - nodes.begin());
+            perNode[domains[i]]++;
+        }
+        if (std::count_if(perNode.begin(), perNode.end(), [](unsigned n) { return n != 0; }) < 2) {
+            return std::vector<size_t>(pool.size(), 0);
+        }
+        weights = perNode;
+        return domains;
+    }
+
+    /** @brief Fills in the placement part of the report; warns if some workers could not be pinned. */
+    void recordPlacement(const ThreadPool& pool, const CpuTopology& topology, bool pin, RunStats& stats) {
+        PlacementSummary& placement = stats.placement;
+        placement.logicalCpus = static_cast<unsigned>(topology.cpus().size());
+        placement.physicalCores = topology.physicalCores();
+        placement.numaNodes = static_cast<unsigned>(topology.nodes().size());
+        placement.topologyDetected = topology.detected();
+        placement.pinRequested = pin;
+        placement.pinnedWorkers = 0;
+        stats.loads.resize(pool.size());
+        for (unsigned i = 0; i < pool.size(); ++i) {
+            if (!pool.pinned(i)) continue;
+            placement.pinnedWorkers++;
+            stats.loads[i].placement.cpu = static_cast<int>(pool.cpu(i).id);
+            stats.loads[i].placement.node = pool.cpu(i).node;
+        }
+        if (pin && placement.pinnedWorkers < pool.size()) {
+            std::cerr << "Warning: Could not pin " << pool.size() - placement.pinnedWorkers << " of "
+                      << pool.size() << " worker threads." << std::endl;
+        }
+    }
+
+    void mergeWorkerStats(const std::vector<WorkerStats>& workerStats, RunStats& stats) {
+        const auto mergeStart = std::chrono::steady_clock::now();
+        for (const auto& worker : workerStats) stats.merged.merge(worker);
+        stats.mergeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - mergeStart).count();
+    }
+
+    /**
+     * @brief As in file mode, a failed run leaves no output file that looks complete. Only
+     * regular files are removed: not stdout ("-"), devices or pipes.
+     */
+    void removeIncompleteOutput(const std::string& filename) {
+        std::error_code ec;
+        if (filename == "-" || !std::filesystem::is_regular_file(filename, ec)) return;
+        std::cerr << "Removing incomplete output." << std::endl;
+        std::remove(filename.c_str());
+    }
+
+    // "-" names stdin / stdout. Neither can be sized or written at an offset, so they
+    // always go through the streaming pipeline.
+    RunResult runStream(const RunConfig& config, const SolveOptions& options, RunStats& stats, std::ostream& log) {
+        if (config.inputFilename != "-" && startsWithPackedMagic(config.inputFilename)) {
+            std::cerr << "Error: Packed input needs file mode: " << config.inputFilename << std::endl;
+            return RunResult::Failed;
+        }
+        std::FILE* input = config.inputFilename == "-" ? stdin : std::fopen(config.inputFilename.c_str(), "rb");
+        if (input == nullptr) {
+            std::cerr << "Error: Cannot open input file: " << config.inputFilename << std::endl;
+            return RunResult::Failed;
+        }
+        std::FILE* output = config.outputFilename == "-" ? stdout : std::fopen(config.outputFilename.c_str(), "wb");
+        if (output == nullptr) {
+            std::cerr << "Error: Cannot open output file for writing: " << config.outputFilename << std::endl;
+            if (input != stdin) std::fclose(input);
+            return RunResult::Failed;
+        }
+        const CpuTopology topology = CpuTopology::detect();
+        const unsigned numThreads = determineThreadCount(config.threads, UINT64_MAX, topology, log);
+        ThreadPool pool(topology.placement(numThreads), config.pinThreads);
+
+        ProgressCounters progress(numThreads);
+        std::vector<WorkerStats> workerStats;
+        const auto solveStart = std::chrono::steady_clock::now();
+        ProgressReporter reporter(progress, 0, config.progress);
+        StreamOptions streamOptions = config.stream;
+        streamOptions.rejectOtherGrids = config.inputFilename == "-" && config.gridSize == 0;
+        bool ok = runStreamPipeline(input, output, pool, streamOptions, config.markers, options,
+                                    stats.loads, workerStats, progress);
+        reporter.stop();
+        recordPlacement(pool, topology, config.pinThreads, stats);
+        stats.solveWallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - solveStart).count();
+        if (input != stdin) std::fclose(input);
+        if (output != stdout && std::fclose(output) != 0) {
+            std::cerr << "Error: Failed closing output file: " << config.outputFilename << std::endl;
+            ok = false;
+        }
+        if (!ok) removeIncompleteOutput(config.outputFilename);
+
+        stats.records = progress.processed();
+        stats.solved = progress.solved();
+        stats.threads = numThreads;
+        stats.chunks = 0;
+        for (const auto& load : stats.loads) stats.chunks += load.chunks;
+        mergeWorkerStats(workerStats, stats);
+        return ok ? RunResult::Completed : RunResult::Failed;
+    }
+
+    // Split-search mode: one puzzle at a time, each searched by the whole pool (ParallelSearch).
+    // Records are read and written in order, like streaming, and go out in blocks of
+    // SPLIT_BLOCK_RECORDS once their retries are done.
+    RunResult runSplit(const RunConfig& config, const SolveOptions& options, RunStats& stats, std::ostream& log) {
+        constexpr uint64_t SPLIT_BLOCK_RECORDS = 64;
+        if (config.inputFilename != "-" && startsWithPackedMagic(config.inputFilename)) {
+            std::cerr << "Error: Packed input needs file mode: " << config.inputFilename << std::endl;
+            return RunResult::Failed;
+        }
+        std::ifstream inputFile;
+        if (config.inputFilename != "-") {
+            inputFile.open(config.inputFilename, std::ios::binary);
+            if (!inputFile) {
+                std::cerr << "Error: Cannot open input file: " << config.inputFilename << std::endl;
+                return RunResult::Failed;
+            }
+        }
+        std::istream& input = config.inputFilename == "-" ? std::cin : inputFile;
+        std::FILE* output = config.outputFilename == "-" ? stdout : std::fopen(config.outputFilename.c_str(), "wb");
+        if (output == nullptr) {
+            std::cerr << "Error: Cannot open output file for writing: " << config.outputFilename << std::endl;
+            return RunResult::Failed;
+        }
+        const CpuTopology topology = CpuTopology::detect();
+        const unsigned numThreads = determineThreadCount(config.threads, UINT64_MAX, topology, log);
+        ThreadPool pool(topology.placement(numThreads), config.pinThreads);
+        ParallelSearch search(pool);
+        SolveOptions splitOptions = options;
+        splitOptions.parallel = &search;
+
+        ProgressCounters progress(1);
+        std::vector<WorkerStats> workerStats(1);
+        RecordSolver solver(config.markers, splitOptions, workerStats[0], progress[0]);
+        const size_t recordSize = solver.recordSize();
+        std::string buffer;
+        uint64_t blockFirst = 0;
+        bool ok = true;
+        const auto flush = [&]() {
+            solver.finish(buffer);
+            if (solver.hasDeferred()) {
+                solver.retryDeferred([&](uint64_t record, const char* data) {
+                    std::memcpy(&buffer[(record - blockFirst) * recordSize], data, recordSize);
+                    return true;
+                });
+            }
+            if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), output) != buffer.size()) {
+                std::cerr << "Error: Failed writing output file: " << config.outputFilename << std::endl;
+                ok = false;
+            }
+            blockFirst = progress.processed();
+            buffer.clear();
+            solver.begin(blockFirst);
+        };
+
+        const auto solveStart = std::chrono::steady_clock::now();
+        ProgressReporter reporter(progress, 0, config.progress);
+        std::string line;
+        char scratch[PUZZLE_SIZE];
+        solver.begin(0);
+        while (ok && std::getline(input, line)) {
+            solver.process(compactRecord(line.data(), line.size(), scratch), buffer);
+            progress[0].addProcessed();
+            if (progress.processed() - blockFirst == SPLIT_BLOCK_RECORDS) flush();
+        }
+        if (ok) flush();
+        if (ok && input.bad()) {
+            std::cerr << "Error: Failed reading input file: " << config.inputFilename << std::endl;
+            ok = false;
+        }
+        reporter.stop();
+        recordPlacement(pool, topology, config.pinThreads, stats);
+        stats.solveWallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - solveStart).count();
+        if (output != stdout && std::fclose(output) != 0) {
+            std::cerr << "Error: Failed closing output file: " << config.outputFilename << std::endl;
+            ok = false;
+        }
+        if (!ok) removeIncompleteOutput(config.outputFilename);
+
+        stats.records = progress.processed();
+        stats.solved = progress.solved();
+        stats.threads = numThreads;
+        stats.chunks = 0;
+        mergeWorkerStats(workerStats, stats);
+        return ok ? RunResult::Completed : RunResult::Failed;
+    }
+
+}
+
+unsigned determineThreadCount(unsigned requested, uint64_t maxUseful, const CpuTopology& topology, std::ostream& log) {
+    unsigned numThreads = requested;
+    if (numThreads == 0 && topology.detected()) {
+        // SMT siblings share a core's execution units and caches, and the solver keeps a core
+        // busy on its own, so one worker per physical core is the sweet spot.
+        numThreads = std::max(1u, topology.physicalCores());
+        log << "Auto-detecting threads: " << numThreads << " (one per physical core)" << std::endl;
+    } else if (numThreads == 0) {
+        unsigned hardware_threads = std::thread::hardware_concurrency();
+        if (hardware_threads > 0) {
+            if (hardware_threads > 4) numThreads = std::max(1u, hardware_threads / 2);
+            else numThreads = hardware_threads;
+            log << "Auto-detecting threads: " << numThreads << std::endl;
+        } else { log << "Warning: Cannot detect concurrency. Using 1 thread." << std::endl; numThreads = 1; }
+    }
+    unsigned maxPossibleThreads = (maxUseful == 0) ? 1 : static_cast<unsigned>(std::min<uint64_t>(maxUseful, UINT_MAX));
+    numThreads = std::min(numThreads, maxPossibleThreads);
+    numThreads = std::max(1u, numThreads);
+    return numThreads;
+}
+
+namespace {
+
+    template <typename T>
+    uint64_t fingerprintValue(uint64_t hash, const T& value) {
+        return fingerprintBytes(hash, &value, sizeof(value));
+    }
+
+    /**
+     * @brief Identifies a checkpointed run: the chunks of the input (where they are and how many
+     * records each holds) and every option that changes the output bytes.
+     */
+    uint64_t runFingerprint(const RunConfig& config, const SolveOptions& options, unsigned gridSize, size_t recordSize,
+                            uint64_t inputSize, const std::vector<InputChunk>& chunks)
+    {
+        uint64_t hash = FINGERPRINT_SEED;
+        hash = fingerprintValue(hash, inputSize);
+        for (const InputChunk& chunk : chunks) {
+            hash = fingerprintValue(hash, chunk.range.begin);
+            hash = fingerprintValue(hash, chunk.range.end);
+            hash = fingerprintValue(hash, chunk.recordCount);
+        }
+        hash = fingerprintValue(hash, gridSize);
+        hash = fingerprintValue(hash, recordSize);
+        hash = fingerprintValue(hash, options.engine);
+        hash = fingerprintValue(hash, options.output);
+        hash = fingerprintValue(hash, options.countLimit);
+        hash = fingerprintValue(hash, options.budget.maxNodes);
+        hash = fingerprintValue(hash, options.budget.maxMillis);
+        hash = fingerprintValue(hash, options.retryAborted);
+        hash = fingerprintValue(hash, options.retryBudget.maxNodes);
+        hash = fingerprintValue(hash, options.retryBudget.maxMillis);
+        hash = fingerprintValue(hash, config.markers.invalid);
+        hash = fingerprintValue(hash, config.markers.unsolvable);
+        hash = fingerprintValue(hash, config.markers.aborted);
+        return hash;
+    }
+
+    bool hasFileSize(const std::string& filename, uint64_t size) {
+        std::error_code ec;
+        const auto actual = std::filesystem::file_size(filename, ec);
+        return !ec && actual == size;
+    }
+
+    // File mode: partition, count, then every chunk is written at its final offset. Grids
+    // other than 9x9 (`gridSize`) are plain text records of N*N cells + '\n'.
+    RunResult runFiles(const RunConfig& config, const SolveOptions& options, unsigned gridSize, RunStats& stats, std::ostream& log) {
+        const std::string& inputFilename = config.inputFilename;
+        const std::string& outputFilename = config.outputFilename;
+        const bool otherGrid = gridSize != 9;
+        const bool packedOutput = options.output == OutputFormat::Packed;
+        const size_t recordSize = otherGrid ? size_t(gridSize) * gridSize + 1
+                                : options.countLimit != 0 ? countRecordSize(options.countLimit)
+                                : packedOutput ? PACKED_STATUS_RECORD_SIZE : OUTPUT_RECORD_SIZE;
+
+        uint64_t inputSize = 0;
+        if (!queryInputSize(inputFilename, inputSize)) {
+             log << "Input file is empty or unreadable. Exiting." << std::endl;
+             return RunResult::Failed;
+        }
+        if (inputSize == 0) {
+             log << "Input file is empty or unreadable. Exiting." << std::endl;
+             return RunResult::EmptyInput;
+        }
+
+        // Packed input and other grid sizes are always mapped: their records are read in place,
+        // whatever --reader says.
+        const bool packedInput = startsWithPackedMagic(inputFilename);
+        if (packedInput && otherGrid) {
+            std::cerr << "Error: Packed files hold 9x9 grids only: " << inputFilename << std::endl;
+            return RunResult::Failed;
+        }
+        bool useMappedReader = config.useMappedReader || packedInput || otherGrid;
+        MappedFile mappedInput;
+        if (useMappedReader && !mappedInput.open(inputFilename)) {
+             if (packedInput || otherGrid) return RunResult::Failed;
+             std::cerr << "Warning: Falling back to the stream reader." << std::endl;
+             useMappedReader = false;
+        }
+        const MappedFile* const mappedInputPtr = useMappedReader ? &mappedInput : nullptr;
+        PackedHeader packedHeader{};
+        if (packedInput) {
+            if (!readPackedHeader(mappedInput.data(), inputSize, packedHeader)) return RunResult::Failed;
+            if (packedHeader.recordCount == 0) {
+                log << "Input file holds no records. Exiting." << std::endl;
+                return RunResult::EmptyInput;
+            }
+        }
+
+        // A thread per record (~82 bytes for 9x9) is the most that can ever be useful.
+        const uint64_t textRecordSize = otherGrid ? recordSize : OUTPUT_RECORD_SIZE;
+        const uint64_t estimatedRecords = packedInput ? packedHeader.recordCount : (inputSize + textRecordSize - 1) / textRecordSize;
+        const CpuTopology topology = CpuTopology::detect();
+        unsigned numThreads = determineThreadCount(config.threads, estimatedRecords, topology, log);
+
+        // Many more chunks than workers, so whoever finishes early keeps pulling work.
+        const auto scanStart = std::chrono::steady_clock::now();
+        const uint64_t chunkTarget = std::max<uint64_t>(numThreads, (inputSize + config.chunkBytes - 1) / config.chunkBytes);
+        std::vector<InputChunk> chunks;
+        if (packedInput) {
+            chunks = packedChunks(packedHeader, chunkTarget);
+        } else {
+            const std::vector<ByteRange> ranges = useMappedReader
+                ? partitionInput(mappedInput.data(), inputSize, chunkTarget)
+                : partitionInput(inputFilename, inputSize, chunkTarget);
+            if (ranges.empty()) {
+                 std::cerr << "Error: Failed to partition input file: " << inputFilename << std::endl;
+                 return RunResult::Failed;
+            }
+            chunks.resize(ranges.size());
+            for (size_t i = 0; i < ranges.size(); ++i) chunks[i].range = ranges[i];
+        }
+        numThreads = std::min<unsigned>(numThreads, static_cast<unsigned>(std::min<size_t>(chunks.size(), UINT_MAX)));
+
+        // One pool for both passes; with pinning each worker keeps its CPU (and node) throughout.
+        ThreadPool pool(topology.placement(numThreads), config.pinThreads);
+        stats.loads.assign(numThreads, WorkerLoad{});
+        recordPlacement(pool, topology, config.pinThreads, stats);
+        std::vector<unsigned> domainWeights;
+        const std::vector<size_t> domains = chunkDomains(pool, topology, domainWeights);
+        stats.placement.perNodeChunks = domainWeights.size() > 1;
+
+        // Output records have a fixed size, so each chunk's slot in the output is known
+        // as soon as the records before it are counted (packed input: from the header).
+        uint64_t totalRecords = packedHeader.recordCount;
+        if (!packedInput && !countChunkRecords(inputFilename, mappedInputPtr, inputSize, pool, domainWeights, domains, chunks, totalRecords)) {
+            return RunResult::Failed;
+        }
+        stats.scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanStart).count();
+
+        const PackedHeader outputHeader = makePackedHeader(totalRecords, PACKED_HAS_STATUS);
+        const uint64_t outputSize = packedOutput ? packedFileSize(outputHeader) : totalRecords * recordSize;
+
+        // A checkpointed run journals every chunk once it is durably in the output; a rerun
+        // with the same input and options skips those and fills in the rest of the same file.
+        RunJournal journal;
+        const std::string journalPath = outputFilename + ".journal";
+        uint64_t skippedRecords = 0;
+        if (config.checkpoint) {
+            const uint64_t fingerprint = runFingerprint(config, options, gridSize, recordSize, inputSize, chunks);
+            if (!journal.open(journalPath, fingerprint, chunks.size())) return RunResult::Failed;
+            if (journal.completedCount() != 0 && !hasFileSize(outputFilename, outputSize)) {
+                std::cerr << "Warning: The output file does not match the checkpoint journal; starting over." << std::endl;
+                if (!journal.open(journalPath, fingerprint, chunks.size(), false)) return RunResult::Failed;
+            }
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                if (journal.completed(i)) skippedRecords += chunks[i].recordCount;
+            }
+            if (journal.completedCount() != 0) {
+                log << "Resuming: " << journal.completedCount() << " of " << chunks.size() << " chunks ("
+                    << skippedRecords << " records) already written." << std::endl;
+            }
+        } else {
+            // The output is about to be truncated, which voids a journal left next to it.
+            std::remove(journalPath.c_str());
+        }
+        RunJournal* const journalPtr = config.checkpoint ? &journal : nullptr;
+
+        PositionalOutputFile outputFile;
+        const bool resuming = journal.completedCount() != 0;
+        const bool opened = packedOutput
+            ? outputFile.open(outputFilename, outputSize, sizeof(PackedHeader), resuming)
+            : outputFile.open(outputFilename, outputSize, 0, resuming);
+        if (!opened) {
+             return RunResult::Failed;
+        }
+
+        ProgressCounters progress(numThreads);
+        std::atomic<bool> workerErrorFlag(false);
+        ChunkScheduler scheduler(chunks.size(), domainWeights);
+        std::vector<WorkerStats> workerStats(numThreads);
+
+        const auto solveStart = std::chrono::steady_clock::now();
+        ProgressReporter reporter(progress, totalRecords - skippedRecords, config.progress);
+        if (journalPtr != nullptr) journal.start(outputFile);
+        pool.run([&](unsigned i) {
+            if (otherGrid) {
+                gridSolverWorker(gridSize, i, mappedInput, outputFile, journalPtr, chunks, scheduler, domains[i], config.markers, options,
+                                 stats.loads[i], workerStats[i], progress[i], workerErrorFlag);
+                return;
+            }
+            solverWorker(i, inputFilename, mappedInputPtr, packedInput ? packedHeader.recordSize : 0, outputFile, journalPtr, chunks,
+                         scheduler, domains[i], config.markers, options, stats.loads[i], workerStats[i], progress[i], workerErrorFlag);
+        });
+        journal.finish();
+        reporter.stop();
+        stats.solveWallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - solveStart).count();
+
+        stats.records = progress.processed();
+        stats.solved = progress.solved();
+        stats.threads = numThreads;
+        stats.chunks = chunks.size();
+        mergeWorkerStats(workerStats, stats);
+
+        outputFile.close();
+
+        if (!workerErrorFlag.load() && packedOutput && !finishPackedFile(outputFilename, outputHeader)) {
+             workerErrorFlag.store(true);
+        }
+        if (workerErrorFlag.load()) {
+             if (config.checkpoint) {
+                 std::cerr << "One or more workers reported an error. Keeping the output and " << journalPath
+                           << " for a resumed run." << std::endl;
+             } else {
+                 std::cerr << "One or more workers reported an error. Removing incomplete output." << std::endl;
+                 std::remove(outputFilename.c_str());
+             }
+             log << "  WARNING: Worker error occurred during processing!" << std::endl;
+             return RunResult::Failed;
+        }
+        journal.remove();
+        return RunResult::Completed;
+    }
+
+
+    // Verify mode: the input holds `puzzle,solution` records (verifierWorker). It is partitioned
+    // and counted like a file-mode run, so every failure has its record number; the output
+    // lists the failing records as `line,reason`, by line number (from 1).
+    RunResult runVerify(const RunConfig& config, RunStats& stats, std::ostream& log) {
+        const std::string& inputFilename = config.inputFilename;
+        if (inputFilename == "-" || startsWithPackedMagic(inputFilename) || startsWithGzipMagic(inputFilename)) {
+            std::cerr << "Error: --verify needs an uncompressed text input file." << std::endl;
+            return RunResult::Failed;
+        }
+        uint64_t inputSize = 0;
+        if (!queryInputSize(inputFilename, inputSize)) {
+             log << "Input file is empty or unreadable. Exiting." << std::endl;
+             return RunResult::Failed;
+        }
+        if (inputSize == 0) {
+             log << "Input file is empty or unreadable. Exiting." << std::endl;
+             return RunResult::EmptyInput;
+        }
+        bool useMappedReader = config.useMappedReader;
+        MappedFile mappedInput;
+        if (useMappedReader && !mappedInput.open(inputFilename)) {
+             std::cerr << "Warning: Falling back to the stream reader." << std::endl;
+             useMappedReader = false;
+        }
+        const MappedFile* const mappedInputPtr = useMappedReader ? &mappedInput : nullptr;
+
+        // Records are `puzzle,solution` + '\n': 164 bytes.
+        const uint64_t estimatedRecords = (inputSize + 2 * OUTPUT_RECORD_SIZE - 1) / (2 * OUTPUT_RECORD_SIZE);
+        const CpuTopology topology = CpuTopology::detect();
+        unsigned numThreads = determineThreadCount(config.threads, estimatedRecords, topology, log);
+
+        const auto scanStart = std::chrono::steady_clock::now();
+        const uint64_t chunkTarget = std::max<uint64_t>(numThreads, (inputSize + config.chunkBytes - 1) / config.chunkBytes);
+        const std::vector<ByteRange> ranges = useMappedReader
+            ? partitionInput(mappedInput.data(), inputSize, chunkTarget)
+            : partitionInput(inputFilename, inputSize, chunkTarget);
+        if (ranges.empty()) {
+             std::cerr << "Error: Failed to partition input file: " << inputFilename << std::endl;
+             return RunResult::Failed;
+        }
+        std::vector<InputChunk> chunks(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i) chunks[i].range = ranges[i];
+        numThreads = std::min<unsigned>(numThreads, static_cast<unsigned>(std::min<size_t>(chunks.size(), UINT_MAX)));
+
+        ThreadPool pool(topology.placement(numThreads), config.pinThreads);
+        stats.loads.assign(numThreads, WorkerLoad{});
+        recordPlacement(pool, topology, config.pinThreads, stats);
+        std::vector<unsigned> domainWeights;
+        const std::vector<size_t> domains = chunkDomains(pool, topology, domainWeights);
+        stats.placement.perNodeChunks = domainWeights.size() > 1;
+        uint64_t totalRecords = 0;
+        if (!countChunkRecords(inputFilename, mappedInputPtr, inputSize, pool, domainWeights, domains, chunks, totalRecords)) {
+            return RunResult::Failed;
+        }
+        stats.scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanStart).count();
+
+        ProgressCounters progress(numThreads);
+        std::atomic<bool> workerErrorFlag(false);
+        ChunkScheduler scheduler(chunks.size(), domainWeights);
+        std::vector<std::vector<VerifyFailure>> workerFailures(numThreads);
+
+        const auto solveStart = std::chrono::steady_clock::now();
+        ProgressReporter reporter(progress, totalRecords, config.progress);
+        pool.run([&](unsigned i) {
+            verifierWorker(i, inputFilename, mappedInputPtr, chunks, scheduler, domains[i], stats.loads[i], progress[i],
+                           workerFailures[i], workerErrorFlag);
+        });
+        reporter.stop();
+        stats.solveWallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - solveStart).count();
+
+        stats.records = progress.processed();
+        stats.solved = progress.solved();
+        stats.threads = numThreads;
+        stats.chunks = chunks.size();
+        if (workerErrorFlag.load()) {
+             log << "  WARNING: Worker error occurred during processing!" << std::endl;
+             return RunResult::Failed;
+        }
+
+        std::vector<VerifyFailure> failures;
+        for (const auto& worker : workerFailures) failures.insert(failures.end(), worker.begin(), worker.end());
+        std::sort(failures.begin(), failures.end(), [](const VerifyFailure& a, const VerifyFailure& b) { return a.record < b.record; });
+
+        std::ofstream outputFile;
+        if (config.outputFilename != "-") {
+            outputFile.open(config.outputFilename, std::ios::binary | std::ios::trunc);
+            if (!outputFile) {
+                std::cerr << "Error: Cannot open output file for writing: " << config.outputFilename << std::endl;
+                return RunResult::Failed;
+            }
+        }
+        std::ostream& output = config.outputFilename == "-" ? std::cout : outputFile;
+        std::string buffer;
+        for (const VerifyFailure& failure : failures) {
+            buffer += std::to_string(failure.record + 1);
+            buffer += ',';
+            buffer += verifyResultName(failure.result);
+            buffer += '\n';
+        }
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        output.flush();
+        if (!output) {
+            std::cerr << "Error: Failed writing output file: " << config.outputFilename << std::endl;
+            return RunResult::Failed;
+        }
+        log << "Verified " << stats.records << " records (" << SolutionVerifier::kernelName() << " kernel): "
+            << stats.solved << " valid, " << failures.size() << " failed." << std::endl;
+        return RunResult::Completed;
+    }
+
+}
+
+RunResult runSolver(const RunConfig& config, RunStats& stats, std::ostream& log) {
+    if (config.verify) return runVerify(config, stats, log);
+    // Compressed files cannot be mapped or written in place: they go through the pipeline.
+    const bool compressed = config.stream.gzipLevel >= 0 || (config.inputFilename != "-" && startsWithGzipMagic(config.inputFilename));
+    if (compressed) {
+        if (!gzipSupported()) {
+            std::cerr << "Error: This build cannot read or write gzip (built without zlib)." << std::endl;
+            return RunResult::Failed;
+        }
+        if (config.splitSearch || config.solve.output == OutputFormat::Packed) {
+            std::cerr << "Error: Gzip input and output need the streaming pipeline (not --split-search or packed output)." << std::endl;
+            return RunResult::Failed;
+        }
+    }
+    const bool streaming = config.streamMode || config.inputFilename == "-" || config.outputFilename == "-" || compressed;
+    unsigned gridSize = config.gridSize;
+    if (gridSize == 0) {
+        // Stdin cannot be read twice: the stream reader checks its first line instead.
+        gridSize = config.inputFilename == "-" || startsWithPackedMagic(config.inputFilename) ? 9 : detectGridSize(config.inputFilename);
+        if (gridSize == 0) {
+            std::cerr << "Error: The first lines of " << config.inputFilename
+                      << " hold grids of different sizes; pass --size=<4|9|16|25>." << std::endl;
+            return RunResult::Failed;
+        }
+        if (gridSize != 9) log << "Detected " << gridSize << "x" << gridSize << " grids." << std::endl;
+    }
+    if (gridSize != 9) {
+        // The other sizes only have the scalar solver and text records.
+        if (streaming) {
+            std::cerr << "Error: " << gridSize << "x" << gridSize << " grids need file mode." << std::endl;
+            return RunResult::Failed;
+        }
+        if (config.solve.countLimit != 0 || config.solve.output == OutputFormat::Packed) {
+            std::cerr << "Error: Solution counting and packed output are for 9x9 grids only." << std::endl;
+            return RunResult::Failed;
+        }
+        if (config.solve.engine != SolverEngine::Scalar) {
+            std::cerr << "Warning: " << gridSize << "x" << gridSize << " grids use the scalar engine." << std::endl;
+        }
+        if (config.useCache) std::cerr << "Warning: The solve cache is for 9x9 grids only; ignoring it." << std::endl;
+        if (config.splitSearch) std::cerr << "Warning: --split-search is for 9x9 grids only; ignoring it." << std::endl;
+        return runFiles(config, config.solve, gridSize, stats, log);
+    }
+    if (config.checkpoint && (streaming || config.splitSearch)) {
+        std::cerr << "Warning: --checkpoint needs file mode (not --stream or --split-search); ignoring it." << std::endl;
+    }
+    const auto run = [&](const SolveOptions& options) {
+        if (config.splitSearch) return runSplit(config, options, stats, log);
+        return streaming ? runStream(config, options, stats, log) : runFiles(config, options, 9, stats, log);
+    };
+    if (!config.useCache) return run(config.solve);
+
+    // The cache lives for the run (and in its file between runs); the workers share it.
+    SolveCache cache(config.cacheEntries);
+    if (!config.cachePath.empty() && !cache.load(config.cachePath)) return RunResult::Failed;
+    stats.cache.enabled = true;
+    stats.cache.loaded = cache.size();
+    if (stats.cache.loaded != 0) log << "Loaded " << stats.cache.loaded << " cached verdicts from " << config.cachePath << std::endl;
+    SolveOptions options = config.solve;
+    options.cache = &cache;
+
+    const RunResult result = run(options);
+    stats.cache.lookups = cache.lookups();
+    stats.cache.hits = cache.hits();
+    stats.cache.entries = cache.size();
+    if (result != RunResult::Failed && !config.cachePath.empty()) {
+        if (cache.save(config.cachePath)) log << "Saved " << stats.cache.entries << " cached verdicts to " << config.cachePath << std::endl;
+        else std::cerr << "Warning: The solve cache was not saved." << std::endl;
+    }
+    return result;
+}
+
+}
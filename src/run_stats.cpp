@@ -0,0 +1,132 @@
+#include "run_stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace SudokuApp {
+
+namespace {
+
+    double millis(double seconds) { return seconds * 1000.0; }
+
+    double micros(uint64_t nanos) { return static_cast<double>(nanos) / 1000.0; }
+
+    double perSecond(uint64_t count, double seconds) { return seconds > 0 ? static_cast<double>(count) / seconds : 0.0; }
+
+    double perPuzzle(uint64_t count, uint64_t puzzles) { return puzzles ? static_cast<double>(count) / static_cast<double>(puzzles) : 0.0; }
+
+    void printPlacement(const PlacementSummary& placement, unsigned workers, std::ostream& out) {
+        out << "  Placement: " << workers << " workers on " << placement.logicalCpus << " CPUs, "
+            << placement.physicalCores << " cores, " << placement.numaNodes << " NUMA node"
+            << (placement.numaNodes == 1 ? "" : "s") << (placement.topologyDetected ? "" : " (no topology information)");
+        if (placement.pinRequested) out << "; pinned " << placement.pinnedWorkers << "/" << workers;
+        else out << "; not pinned";
+        if (placement.perNodeChunks) out << ", chunks split per node";
+        out << std::endl;
+    }
+
+}
+
+void printLoadReport(const std::vector<WorkerLoad>& loads, size_t chunkCount, double wallSeconds, std::ostream& out) {
+    out << "Load report: " << loads.size() << " workers, " << chunkCount << " chunks, "
+        << static_cast<long long>(wallSeconds * 1000.0) << " ms wall" << std::endl;
+    for (size_t i = 0; i < loads.size(); ++i) {
+        const double busy = loads[i].busySeconds;
+        const double idle = std::max(0.0, wallSeconds - busy);
+        out << "  Worker " << i << ": " << loads[i].chunks << " chunks, " << loads[i].records << " records, busy "
+            << static_cast<long long>(busy * 1000.0) << " ms, idle " << static_cast<long long>(idle * 1000.0)
+            << " ms (" << static_cast<int>(wallSeconds > 0 ? 100.0 * busy / wallSeconds : 100.0) << "% busy)";
+        if (loads[i].placement.cpu >= 0) out << ", cpu " << loads[i].placement.cpu << " node " << loads[i].placement.node;
+        out << std::endl;
+    }
+}
+
+
+void printRunStats(const RunStats& stats, StatsFormat format, std::ostream& out) {
+    const LatencyHistogram& latency = stats.merged.solveLatency;
+    const SearchStats& search = stats.merged.search;
+    const double rate = perSecond(stats.records, stats.solveWallSeconds);
+    const std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+
+    if (format == StatsFormat::Json) {
+        out << "{\n"
+            << "  \"records\": " << stats.records << ",\n"
+            << "  \"solved\": " << stats.solved << ",\n"
+            << "  \"threads\": " << stats.threads << ",\n"
+            << "  \"chunks\": " << stats.chunks << ",\n"
+            << "  \"placement\": { \"cpus\": " << stats.placement.logicalCpus
+            << ", \"cores\": " << stats.placement.physicalCores
+            << ", \"numa_nodes\": " << stats.placement.numaNodes
+            << ", \"topology\": " << (stats.placement.topologyDetected ? "true" : "false")
+            << ", \"pinned\": " << stats.placement.pinnedWorkers
+            << ", \"per_node_chunks\": " << (stats.placement.perNodeChunks ? "true" : "false") << " },\n"
+            << "  \"cache\": { \"enabled\": " << (stats.cache.enabled ? "true" : "false")
+            << ", \"loaded\": " << stats.cache.loaded
+            << ", \"lookups\": " << stats.cache.lookups
+            << ", \"hits\": " << stats.cache.hits
+            << ", \"entries\": " << stats.cache.entries << " },\n"
+            << "  \"puzzles_per_second\": " << rate << ",\n"
+            << "  \"phases_ms\": { \"scan\": " << millis(stats.scanSeconds)
+            << ", \"solve_wall\": " << millis(stats.solveWallSeconds);
+        if (SUDOKU_STATS) {
+            out << ", \"solve\": " << millis(stats.merged.solveSeconds)
+                << ", \"write\": " << millis(stats.merged.writeSeconds);
+        }
+        out << ", \"merge\": " << millis(stats.mergeSeconds) << " },\n";
+        out << "  \"instrumented\": " << (SUDOKU_STATS ? "true" : "false");
+        if (SUDOKU_STATS) {
+            out << ",\n  \"solve_us\": { \"p50\": " << micros(latency.percentile(50.0))
+                << ", \"p99\": " << micros(latency.percentile(99.0))
+                << ", \"p99.9\": " << micros(latency.percentile(99.9))
+                << ", \"max\": " << micros(latency.max())
+                << ", \"mean\": " << latency.mean() / 1000.0 << " },\n"
+                << "  \"search\": { \"nodes\": " << search.nodes
+                << ", \"guesses\": " << search.guesses
+                << ", \"backtracks\": " << search.backtracks << " }";
+        }
+        out << ",\n  \"workers\": [";
+        for (size_t i = 0; i < stats.loads.size(); ++i) {
+            const WorkerLoad& load = stats.loads[i];
+            out << (i ? ", " : "") << "{ \"chunks\": " << load.chunks << ", \"records\": " << load.records
+                << ", \"busy_ms\": " << millis(load.busySeconds) << ", \"cpu\": " << load.placement.cpu
+                << ", \"node\": " << load.placement.node << " }";
+        }
+        out << "]\n}" << std::endl;
+        out.flags(flags);
+        return;
+    }
+
+    out << "Stats: " << stats.records << " records (" << stats.solved << " solved) in "
+        << millis(stats.solveWallSeconds) << " ms, " << std::setprecision(0) << rate << " puzzles/s" << std::endl;
+    out << std::setprecision(3);
+    out << "  Phases: scan " << millis(stats.scanSeconds) << " ms";
+    if (SUDOKU_STATS) {
+        out << ", solve " << millis(stats.merged.solveSeconds) << " ms, write "
+            << millis(stats.merged.writeSeconds) << " ms (summed over workers)";
+    }
+    out << ", merge " << millis(stats.mergeSeconds) << " ms" << std::endl;
+    if (SUDOKU_STATS) {
+        out << "  Solve time (us): p50 " << micros(latency.percentile(50.0))
+            << ", p99 " << micros(latency.percentile(99.0))
+            << ", p99.9 " << micros(latency.percentile(99.9))
+            << ", max " << micros(latency.max())
+            << ", mean " << latency.mean() / 1000.0 << std::endl;
+        out << "  Search: " << search.nodes << " nodes, " << search.guesses << " guesses, " << search.backtracks
+            << " backtracks (" << perPuzzle(search.nodes, latency.count()) << " / "
+            << perPuzzle(search.guesses, latency.count()) << " / "
+            << perPuzzle(search.backtracks, latency.count()) << " per puzzle)" << std::endl;
+    } else {
+        out << "  Solve-time percentiles and search counts need a build with SUDOKU_STATS=1." << std::endl;
+    }
+    if (stats.cache.enabled) {
+        out << "  Cache: " << stats.cache.hits << " hits of " << stats.cache.lookups << " lookups ("
+            << std::setprecision(1) << (stats.cache.lookups ? 100.0 * stats.cache.hits / stats.cache.lookups : 0.0)
+            << "%), " << stats.cache.entries << " entries (" << stats.cache.loaded << " loaded)" << std::endl;
+    }
+    out.flags(flags);
+    printPlacement(stats.placement, stats.threads, out);
+    printLoadReport(stats.loads, stats.chunks, stats.solveWallSeconds, out);
+}
+
+}
@@ -0,0 +1,219 @@
+#include "solution_verifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SUDOKU_VERIFY_SSE2 1
+#else
+    #define SUDOKU_VERIFY_SSE2 0
+#endif
+
+namespace SudokuApp {
+
+namespace {
+
+    constexpr size_t CELLS = 81;
+    constexpr size_t RECORD_CELLS = 2 * CELLS;
+    constexpr uint16_t ALL_DIGITS = 0x3FE;
+
+    /** A unit is valid if no two of its cells are equal: the pairs to compare, by kind. */
+    struct CellPairs {
+        static constexpr size_t ROW_PAIRS = 9 * 36;
+        static constexpr size_t COLUMN_PAIRS = 9 * 36;
+        static constexpr size_t BOX_PAIRS = 9 * 18;     ///< Only those in different rows and columns.
+        static constexpr size_t COUNT = ROW_PAIRS + COLUMN_PAIRS + BOX_PAIRS;
+
+        std::array<uint8_t, COUNT> first{};
+        std::array<uint8_t, COUNT> second{};
+
+        constexpr CellPairs() {
+            size_t n = 0;
+            for (size_t r = 0; r < 9; ++r) {
+                for (size_t a = 0; a < 9; ++a) {
+                    for (size_t b = a + 1; b < 9; ++b) { first[n] = static_cast<uint8_t>(9 * r + a); second[n] = static_cast<uint8_t>(9 * r + b); ++n; }
+                }
+            }
+            for (size_t c = 0; c < 9; ++c) {
+                for (size_t a = 0; a < 9; ++a) {
+                    for (size_t b = a + 1; b < 9; ++b) { first[n] = static_cast<uint8_t>(9 * a + c); second[n] = static_cast<uint8_t>(9 * b + c); ++n; }
+                }
+            }
+            for (size_t box = 0; box < 9; ++box) {
+                const size_t top = (box / 3) * 3;
+                const size_t left = (box % 3) * 3;
+                for (size_t i = 0; i < 9; ++i) {
+                    for (size_t j = i + 1; j < 9; ++j) {
+                        if (i / 3 == j / 3 || i % 3 == j % 3) continue;
+                        first[n] = static_cast<uint8_t>(9 * (top + i / 3) + left + i % 3);
+                        second[n] = static_cast<uint8_t>(9 * (top + j / 3) + left + j % 3);
+                        ++n;
+                    }
+                }
+            }
+        }
+    };
+
+    constexpr CellPairs PAIRS{};
+
+    inline bool isDigit(char c) {
+        return static_cast<unsigned char>(c - '1') < 9;
+    }
+
+#if SUDOKU_VERIFY_SSE2
+    /** @brief Transposes 16 rows of 16 bytes (`stride` apart) into `out` (16 rows of 16). */
+    void transpose16(const uint8_t* in, size_t stride, uint8_t* out) {
+        __m128i rows[16];
+        for (int i = 0; i < 16; ++i) rows[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i * stride));
+        // Four rounds of interleaving row i with row i + 8 move every byte to its transposed slot.
+        for (int round = 0; round < 4; ++round) {
+            __m128i next[16];
+            for (int i = 0; i < 8; ++i) {
+                next[2 * i] = _mm_unpacklo_epi8(rows[i], rows[i + 8]);
+                next[2 * i + 1] = _mm_unpackhi_epi8(rows[i], rows[i + 8]);
+            }
+            for (int i = 0; i < 16; ++i) rows[i] = next[i];
+        }
+        for (int i = 0; i < 16; ++i) _mm_store_si128(reinterpret_cast<__m128i*>(out + i * 16), rows[i]);
+    }
+
+    /** @brief Lanes (one bit each) in which some pair of `PAIRS` in [begin, end) is equal. */
+    unsigned conflictLanes(const uint8_t (&cells)[96][SolutionVerifier::LANES], size_t begin, size_t end) {
+        __m128i equal = _mm_setzero_si128();
+        for (size_t p = begin; p < end; ++p) {
+            const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(cells[PAIRS.first[p]]));
+            const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(cells[PAIRS.second[p]]));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi8(a, b));
+        }
+        return static_cast<unsigned>(_mm_movemask_epi8(equal));
+    }
+#endif
+
+}
+
+const char* verifyResultName(VerifyResult result) {
+    switch (result) {
+        case VerifyResult::Valid: return "valid";
+        case VerifyResult::Malformed: return "malformed";
+        case VerifyResult::BadCell: return "bad-cell";
+        case VerifyResult::ClueMismatch: return "clue";
+        case VerifyResult::RowConflict: return "row";
+        case VerifyResult::ColumnConflict: return "column";
+        default: return "box";
+    }
+}
+
+bool splitVerifyRecord(const char* record, size_t len, char (&scratch)[162], const char*& puzzle, const char*& solution) {
+    if (len == RECORD_CELLS + 1 && record[CELLS] == ',') {
+        // Smallest byte of the record: below '!' means a blank or control character to strip.
+        unsigned char lowest = 0xFF;
+        for (size_t i = 0; i < len; ++i) lowest = std::min(lowest, static_cast<unsigned char>(record[i]));
+        if (lowest > ' ') {
+            puzzle = record;
+            solution = record + CELLS + 1;
+            return true;
+        }
+    }
+    size_t count = 0;
+    bool separated = false;
+    for (size_t i = 0; i < len; ++i) {
+        const unsigned char c = static_cast<unsigned char>(record[i]);
+        if (std::isspace(c)) continue;
+        if (c == ',' && !separated) { separated = true; continue; }
+        if (count == RECORD_CELLS) return false;
+        scratch[count++] = static_cast<char>(c);
+    }
+    if (count != RECORD_CELLS) return false;
+    puzzle = scratch;
+    solution = scratch + CELLS;
+    return true;
+}
+
+VerifyResult verifySolution(const char* puzzle, const char* solution) {
+    for (size_t i = 0; i < CELLS; ++i) {
+        if (!isDigit(solution[i])) return VerifyResult::BadCell;
+    }
+    for (size_t i = 0; i < CELLS; ++i) {
+        if (isDigit(puzzle[i]) && puzzle[i] != solution[i]) return VerifyResult::ClueMismatch;
+    }
+    // Nine digits from 1-9 cover all nine bits only if they are all different.
+    uint16_t rows[9] = {};
+    uint16_t cols[9] = {};
+    uint16_t boxes[9] = {};
+    for (size_t i = 0; i < CELLS; ++i) {
+        const uint16_t bit = static_cast<uint16_t>(1u << (solution[i] - '0'));
+        rows[i / 9] |= bit;
+        cols[i % 9] |= bit;
+        boxes[(i / 27) * 3 + (i % 9) / 3] |= bit;
+    }
+    for (size_t u = 0; u < 9; ++u) if (rows[u] != ALL_DIGITS) return VerifyResult::RowConflict;
+    for (size_t u = 0; u < 9; ++u) if (cols[u] != ALL_DIGITS) return VerifyResult::ColumnConflict;
+    for (size_t u = 0; u < 9; ++u) if (boxes[u] != ALL_DIGITS) return VerifyResult::BoxConflict;
+    return VerifyResult::Valid;
+}
+
+// The padding makes every lane 6 full vectors of a valid-looking cell and an empty clue.
+SolutionVerifier::SolutionVerifier() {
+    std::memset(grids, '1', sizeof(grids));
+    std::memset(clues, '0', sizeof(clues));
+}
+
+void SolutionVerifier::verify(const char* const* puzzles, const char* const* solutions, size_t count, VerifyResult* results) {
+    for (size_t lane = 0; lane < count; ++lane) load(lane, puzzles[lane], solutions[lane]);
+    check(count, results);
+}
+
+// Lanes at and above `count` hold older (or padding) grids; they are checked along and dropped.
+void SolutionVerifier::check(size_t count, VerifyResult* results) {
+#if SUDOKU_VERIFY_SSE2
+    // Per record: every solution cell in '1'-'9', every clue kept.
+    const __m128i one = _mm_set1_epi8('1');
+    const __m128i eight = _mm_set1_epi8(8);
+    const __m128i zero = _mm_setzero_si128();
+    unsigned badCells = 0;
+    unsigned badClues = 0;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        __m128i outOfRange = zero;
+        __m128i changed = zero;
+        for (size_t v = 0; v < 96; v += 16) {
+            const __m128i s = _mm_load_si128(reinterpret_cast<const __m128i*>(grids[lane] + v));
+            const __m128i p = _mm_load_si128(reinterpret_cast<const __m128i*>(clues[lane] + v));
+            // x - '1' saturated down by 8 is zero exactly for '1'-'9'.
+            const __m128i digit = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(s, one), eight), zero);
+            const __m128i clue = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(p, one), eight), zero);
+            outOfRange = _mm_or_si128(outOfRange, _mm_cmpeq_epi8(digit, zero));
+            changed = _mm_or_si128(changed, _mm_andnot_si128(_mm_cmpeq_epi8(p, s), clue));
+        }
+        badCells |= (_mm_movemask_epi8(outOfRange) != 0 ? 1u : 0u) << lane;
+        badClues |= (_mm_movemask_epi8(changed) != 0 ? 1u : 0u) << lane;
+    }
+
+    // All records at once: one vector per cell, one compare per cell pair.
+    for (size_t v = 0; v < 96; v += 16) transpose16(&grids[0][v], sizeof(grids[0]), cells[v]);
+    const unsigned rowConflicts = conflictLanes(cells, 0, CellPairs::ROW_PAIRS);
+    const unsigned columnConflicts = conflictLanes(cells, CellPairs::ROW_PAIRS, CellPairs::ROW_PAIRS + CellPairs::COLUMN_PAIRS);
+    const unsigned boxConflicts = conflictLanes(cells, CellPairs::ROW_PAIRS + CellPairs::COLUMN_PAIRS, CellPairs::COUNT);
+
+    for (size_t lane = 0; lane < count; ++lane) {
+        const unsigned bit = 1u << lane;
+        results[lane] = (badCells & bit) ? VerifyResult::BadCell
+                      : (badClues & bit) ? VerifyResult::ClueMismatch
+                      : (rowConflicts & bit) ? VerifyResult::RowConflict
+                      : (columnConflicts & bit) ? VerifyResult::ColumnConflict
+                      : (boxConflicts & bit) ? VerifyResult::BoxConflict : VerifyResult::Valid;
+    }
+#else
+    for (size_t lane = 0; lane < count; ++lane) {
+        results[lane] = verifySolution(reinterpret_cast<const char*>(clues[lane]), reinterpret_cast<const char*>(grids[lane]));
+    }
+#endif
+}
+
+const char* SolutionVerifier::kernelName() {
+    return SUDOKU_VERIFY_SSE2 ? "sse2" : "scalar";
+}
+
+}
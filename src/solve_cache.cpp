@@ -0,0 +1,219 @@
+#include "solve_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+namespace SudokuApp {
+
+namespace {
+
+    const char CACHE_MAGIC[8] = {'S', 'U', 'D', 'O', 'K', 'U', 'C', 'A'};
+    constexpr uint32_t CACHE_VERSION = 2;
+
+    /**
+     * Cache files: this header, then `entries` fixed-size entries as held in memory, each
+     * followed by its checksum (`blockChecksum` of the entry bytes).
+     */
+    struct CacheFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entrySize;
+        uint64_t entries;
+    };
+    static_assert(sizeof(CacheFileHeader) == 24, "the cache file header is 24 bytes on disk");
+
+    /** @brief True if `solution` is a complete valid grid that keeps every clue of `puzzle`. */
+    bool completes(const char* puzzle, const char* solution) {
+        uint16_t rows[9] = {};
+        uint16_t cols[9] = {};
+        uint16_t boxes[9] = {};
+        for (size_t i = 0; i < CanonicalForm::CELLS; ++i) {
+            if (solution[i] < '1' || solution[i] > '9') return false;
+            if (puzzle[i] != '0' && puzzle[i] != solution[i]) return false;
+            const uint16_t bit = static_cast<uint16_t>(1u << (solution[i] - '0'));
+            const size_t r = i / 9;
+            const size_t c = i % 9;
+            const size_t b = (r / 3) * 3 + c / 3;
+            if ((rows[r] | cols[c] | boxes[b]) & bit) return false;
+            rows[r] |= bit;
+            cols[c] |= bit;
+            boxes[b] |= bit;
+        }
+        return true;
+    }
+
+    /**
+     * @brief True if `puzzle` can be an unsolvable puzzle: its clues do not clash (that would
+     * make it invalid) and it has an empty cell (a full grid without clashes is solved).
+     */
+    bool canBeUnsolvable(const char* puzzle) {
+        uint16_t rows[9] = {};
+        uint16_t cols[9] = {};
+        uint16_t boxes[9] = {};
+        bool empty = false;
+        for (size_t i = 0; i < CanonicalForm::CELLS; ++i) {
+            if (puzzle[i] == '0') {
+                empty = true;
+                continue;
+            }
+            const uint16_t bit = static_cast<uint16_t>(1u << (puzzle[i] - '0'));
+            const size_t r = i / 9;
+            const size_t c = i % 9;
+            const size_t b = (r / 3) * 3 + c / 3;
+            if ((rows[r] | cols[c] | boxes[b]) & bit) return false;
+            rows[r] |= bit;
+            cols[c] |= bit;
+            boxes[b] |= bit;
+        }
+        return empty;
+    }
+
+}
+
+SolveCache::SolveCache(size_t maxEntries)
+    : shards(new Shard[SHARDS]),
+      maxPerShard(std::max<size_t>(1, (maxEntries + SHARDS - 1) / SHARDS))
+{
+}
+
+bool SolveCache::lookup(const CanonicalForm& form, RecordStatus& status, char* solution) {
+    Shard& shard = shardFor(form.hash);
+    shard.lookups.fetch_add(1, std::memory_order_relaxed);
+    uint8_t puzzle[PACKED_CELLS_SIZE];
+    packCells(form.cells, puzzle);
+    Entry entry;
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        const auto found = shard.entries.find(form.hash);
+        if (found == shard.entries.end() || std::memcmp(found->second.puzzle, puzzle, PACKED_CELLS_SIZE) != 0) return false;
+        entry = found->second;
+    }
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    status = entry.status;
+    if (status == RecordStatus::Solved) {
+        char canonical[CanonicalForm::CELLS];
+        unpackText(entry.solution, canonical);
+        form.fromCanonical(canonical, solution);
+    }
+    return true;
+}
+
+void SolveCache::insert(const CanonicalForm& form, RecordStatus status, const char* solution) {
+    if (status != RecordStatus::Solved && status != RecordStatus::Unsolvable) return;
+    Entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    packCells(form.cells, entry.puzzle);
+    entry.status = status;
+    if (status == RecordStatus::Solved) {
+        char canonical[CanonicalForm::CELLS];
+        form.toCanonical(solution, canonical);
+        packCells(canonical, entry.solution);
+    }
+    add(form.hash, entry);
+}
+
+// An existing entry wins: it is the same puzzle, or (rarely) a hash collision that stays a miss.
+bool SolveCache::add(uint64_t hash, const Entry& entry) {
+    Shard& shard = shardFor(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (shard.entries.size() >= maxPerShard) return false;
+    shard.entries.emplace(hash, entry);
+    return true;
+}
+
+bool SolveCache::load(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return true;
+    CacheFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+        || header.version != CACHE_VERSION || header.entrySize != sizeof(Entry) + sizeof(uint32_t)) {
+        std::cerr << "Error: Not a solve cache file (or an unsupported version): " << filename << std::endl;
+        return false;
+    }
+    // Entries are checked before they are trusted: a damaged file must not turn into wrong solutions.
+    char puzzle[CanonicalForm::CELLS];
+    char solution[CanonicalForm::CELLS];
+    for (uint64_t i = 0; i < header.entries; ++i) {
+        Entry entry;
+        uint32_t checksum = 0;
+        if (!in.read(reinterpret_cast<char*>(&entry), sizeof(entry)) || !in.read(reinterpret_cast<char*>(&checksum), sizeof(checksum))) {
+            std::cerr << "Error: Solve cache file is truncated: " << filename << std::endl;
+            return false;
+        }
+        const bool solved = entry.status == RecordStatus::Solved;
+        if (checksum != blockChecksum(reinterpret_cast<const uint8_t*>(&entry), sizeof(entry)) || !unpackText(entry.puzzle, puzzle)
+            || (!solved && (entry.status != RecordStatus::Unsolvable || !canBeUnsolvable(puzzle)))
+            || (solved && (!unpackText(entry.solution, solution) || !completes(puzzle, solution)))) {
+            std::cerr << "Error: Solve cache file has a corrupt entry (" << i << "): " << filename << std::endl;
+            return false;
+        }
+        add(canonicalHash(puzzle), entry);
+    }
+    return true;
+}
+
+// Written next to the old file and renamed over it, so a failed save keeps the previous cache.
+bool SolveCache::save(const std::string& filename) const {
+    const std::string temporary = filename + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Cannot open solve cache file for writing: " << filename << std::endl;
+        return false;
+    }
+    CacheFileHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.entrySize = sizeof(Entry) + sizeof(uint32_t);
+    header.entries = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t s = 0; s < SHARDS; ++s) {
+        std::shared_lock<std::shared_mutex> lock(shards[s].mutex);
+        for (const auto& item : shards[s].entries) {
+            const uint32_t checksum = blockChecksum(reinterpret_cast<const uint8_t*>(&item.second), sizeof(Entry));
+            out.write(reinterpret_cast<const char*>(&item.second), sizeof(Entry));
+            out.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+            header.entries++;
+        }
+    }
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Failed writing solve cache file: " << temporary << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    std::remove(filename.c_str());
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Error: Failed replacing solve cache file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t SolveCache::size() const {
+    size_t total = 0;
+    for (size_t s = 0; s < SHARDS; ++s) {
+        std::shared_lock<std::shared_mutex> lock(shards[s].mutex);
+        total += shards[s].entries.size();
+    }
+    return total;
+}
+
+uint64_t SolveCache::lookups() const {
+    uint64_t total = 0;
+    for (size_t s = 0; s < SHARDS; ++s) total += shards[s].lookups.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t SolveCache::hits() const {
+    uint64_t total = 0;
+    for (size_t s = 0; s < SHARDS; ++s) total += shards[s].hits.load(std::memory_order_relaxed);
+    return total;
+}
+
+}
@@ -0,0 +1,100 @@
+#include "solver_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SudokuApp {
+
+namespace {
+
+    /** Puzzles per claim: a multiple of the batch engine's lanes, big enough to keep the cursor cold. */
+    constexpr size_t BLOCK = 4 * BatchSolver::LANES;
+
+    unsigned poolSize(unsigned threads) {
+        return threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+}
+
+struct SolverPool::ThreadState {
+    SudokuSolver solver;
+    BatchSolver batchSolver;
+    DlxSolver dlxSolver;
+};
+
+SolverPool::SolverPool(unsigned threads) : threads(poolSize(threads)) {
+    states.reserve(this->threads.size());
+    for (unsigned i = 0; i < this->threads.size(); ++i) states.emplace_back(new ThreadState());
+}
+
+SolverPool::~SolverPool() = default;
+
+SolverPool& SolverPool::shared() {
+    // Never destroyed: joining threads from a static destructor can deadlock when the
+    // library is unloaded, and the OS reclaims the threads at exit anyway.
+    static SolverPool* pool = new SolverPool();
+    return *pool;
+}
+
+void SolverPool::solveBatch(const char* puzzles, size_t count, char* solutions, RecordStatus* statuses, const SolveOptions& options) {
+    if (count == 0) return;
+    std::lock_guard<std::mutex> call(callMutex);
+    batch = Batch{puzzles, count, solutions, statuses, &options};
+    cursor.store(0, std::memory_order_relaxed);
+
+    if (count <= BLOCK || threads.size() == 1) {
+        work(*states[0]);
+        return;
+    }
+    threads.run([this](unsigned worker) { work(*states[worker]); });
+}
+
+void SolverPool::work(ThreadState& state) {
+    const Batch job = batch;
+    const SolveOptions& options = *job.options;
+    state.solver.setBudget(options.budget);
+    state.batchSolver.setBudget(options.budget);
+    state.dlxSolver.setBudget(options.budget);
+
+    auto store = [&](size_t i, RecordStatus status, const char* solution) {
+        const char* puzzle = job.puzzles + i * PUZZLE_SIZE;
+        char* out = job.solutions + i * PUZZLE_SIZE;
+        const char* source = status == RecordStatus::Solved ? solution : puzzle;
+        if (source != out) std::memcpy(out, source, PUZZLE_SIZE);
+        if (job.statuses != nullptr) job.statuses[i] = status;
+    };
+
+    for (;;) {
+        const size_t first = cursor.fetch_add(BLOCK, std::memory_order_relaxed);
+        if (first >= job.count) return;
+        const size_t end = std::min(job.count, first + BLOCK);
+
+        if (options.engine == SolverEngine::Batch) {
+            const char* lanes[BatchSolver::LANES];
+            for (size_t group = first; group < end; group += BatchSolver::LANES) {
+                const size_t n = std::min(BatchSolver::LANES, end - group);
+                for (size_t k = 0; k < n; ++k) lanes[k] = job.puzzles + (group + k) * PUZZLE_SIZE;
+                state.batchSolver.solve(lanes, n);
+                for (size_t k = 0; k < n; ++k) {
+                    const BatchSolver& solver = state.batchSolver;
+                    const RecordStatus status = !solver.valid(k) ? RecordStatus::Invalid
+                                              : solver.aborted(k) ? RecordStatus::Aborted
+                                              : solver.solved(k) ? RecordStatus::Solved : RecordStatus::Unsolvable;
+                    store(group + k, status, solver.solution(k));
+                }
+            }
+        } else if (options.engine == SolverEngine::Dlx) {
+            for (size_t i = first; i < end; ++i) {
+                const RecordStatus status = solveRecord(state.dlxSolver, job.puzzles + i * PUZZLE_SIZE);
+                store(i, status, state.dlxSolver.getSolution());
+            }
+        } else {
+            for (size_t i = first; i < end; ++i) {
+                const RecordStatus status = solveRecord(state.solver, job.puzzles + i * PUZZLE_SIZE);
+                store(i, status, state.solver.getSolution());
+            }
+        }
+    }
+}
+
+}
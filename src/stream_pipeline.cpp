@@ -0,0 +1,391 @@
+#include "stream_pipeline.hpp"
+#include "compressed_stream.hpp"
+#include "input_partition.hpp"
+#include "packed_format.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <fcntl.h>
+    #include <io.h>
+#else
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace SudokuApp {
+
+namespace {
+
+    /** Bytes asked for per read; a pipe usually returns less. */
+    constexpr size_t READ_BLOCK = 1 << 20;
+
+    /** Longer lines are invalid records; this keeps a line without '\n' from growing without bound. */
+    constexpr size_t MAX_LINE = 4096;
+
+    /** The packed-file magic is the longest one the reader looks for. */
+    constexpr size_t MAGIC_BYTES = sizeof(PackedHeader::magic);
+
+    /**
+     * @brief Slot life cycle. Sequence number `s` lives in slot `s % capacity`; its stamp is
+     * `s * PHASES + phase`, and the writer frees it for sequence `s + capacity`.
+     */
+    enum SlotPhase : uint64_t { FREE = 0, FILLED = 1, SOLVED = 2, PHASES = 3 };
+
+    struct Slot {
+        alignas(64) std::atomic<uint64_t> stamp{0};
+        uint64_t firstRecord = 0;
+        size_t count = 0;
+        std::unique_ptr<char[]> cells;      ///< `count` compacted records of PUZZLE_SIZE bytes.
+        std::unique_ptr<bool[]> valid;      ///< False for lines that are not 81 cells.
+        std::string output;                 ///< `count` output records, filled in by a worker.
+        std::string compressed;             ///< `output` as gzip members, if the output is compressed.
+    };
+
+    class SlotRing {
+    public:
+        SlotRing(size_t capacity, size_t slotRecords) : capacity(capacity), slots(capacity) {
+            for (size_t i = 0; i < capacity; ++i) {
+                slots[i].stamp.store(i * PHASES + FREE, std::memory_order_relaxed);
+                slots[i].cells.reset(new char[slotRecords * PUZZLE_SIZE]);
+                slots[i].valid.reset(new bool[slotRecords]);
+            }
+        }
+
+        Slot& at(uint64_t sequence) { return slots[sequence % capacity]; }
+
+        bool reached(uint64_t sequence, SlotPhase phase) {
+            return at(sequence).stamp.load(std::memory_order_acquire) == sequence * PHASES + phase;
+        }
+
+        void publish(uint64_t sequence, SlotPhase phase) {
+            at(sequence).stamp.store(sequence * PHASES + phase, std::memory_order_release);
+        }
+
+        /** @brief Hands the slot of `sequence` back to the reader for `sequence + capacity`. */
+        void recycle(uint64_t sequence) {
+            at(sequence).stamp.store((sequence + capacity) * PHASES + FREE, std::memory_order_release);
+        }
+
+        const size_t capacity;
+
+    private:
+        std::vector<Slot> slots;
+    };
+
+    /**
+     * @brief Spins briefly, then yields, then sleeps: waits are short while the pipeline flows,
+     * and an idle pipeline (quiet producer, stalled consumer) wakes up about once a millisecond.
+     */
+    void backoff(unsigned& spins) {
+        ++spins;
+        if (spins < 64) return;
+        if (spins < 256) std::this_thread::yield();
+        else if (spins < 2048) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        else std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    /** @brief Reads what is available, up to `size` bytes. @return Bytes read, 0 at end of input, -1 on error. */
+    long long readSome(std::FILE* file, char* buffer, size_t size) {
+#if defined(_WIN32)
+        return _read(_fileno(file), buffer, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+#else
+        for (;;) {
+            const ssize_t n = ::read(fileno(file), buffer, size);
+            if (n >= 0 || errno != EINTR) return n;
+        }
+#endif
+    }
+
+    /**
+     * @brief First read of the input: reads until `buffer` holds a line break or MAGIC_BYTES bytes,
+     * enough to tell gzip and packed files from text even when a pipe hands them out byte by byte.
+     * @return Bytes read, 0 for an empty input, -1 on error.
+     */
+    template <typename Read>
+    long long readStart(Read read, char* buffer) {
+        size_t have = 0;
+        while (have < MAGIC_BYTES && std::memchr(buffer, '\n', have) == nullptr) {
+            const long long n = read(buffer + have, READ_BLOCK - have);
+            if (n < 0) return n;
+            if (n == 0) break;
+            have += static_cast<size_t>(n);
+        }
+        return static_cast<long long>(have);
+    }
+
+    bool writeAll(std::FILE* file, const char* data, size_t size) {
+        while (size > 0) {
+#if defined(_WIN32)
+            const int n = _write(_fileno(file), data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+#else
+            const ssize_t n = ::write(fileno(file), data, size);
+            if (n < 0 && errno == EINTR) continue;
+#endif
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    struct PipelineState {
+        alignas(64) std::atomic<uint64_t> nextToSolve{0};
+        alignas(64) std::atomic<uint64_t> produced{0};  ///< Slots published by the reader.
+        std::atomic<bool> inputDone{false};             ///< Set after the last `produced` update.
+        std::atomic<bool> failed{false};
+    };
+
+    /** @brief True once sequence `s` will never be produced (the input ended before it). */
+    bool pastEnd(const PipelineState& state, uint64_t s) {
+        return state.inputDone.load(std::memory_order_acquire) && s >= state.produced.load(std::memory_order_acquire);
+    }
+
+    void readerThread(std::FILE* input, size_t slotRecords, unsigned inflateThreads, bool rejectOtherGrids, SlotRing& ring,
+                      PipelineState& state) {
+        std::unique_ptr<char[]> block(new char[READ_BLOCK]);
+        // Gzip input is known by its first bytes; from then on the reader reads through the decoder.
+        std::unique_ptr<GzipReader> gzip;
+        bool first = true;
+        bool rejected = false;      // The input is not text; the error is printed.
+        auto readInput = [&]() -> long long {
+            if (!first) return gzip ? gzip->read(block.get(), READ_BLOCK) : readSome(input, block.get(), READ_BLOCK);
+            first = false;
+            long long n = readStart([&](char* buffer, size_t size) { return readSome(input, buffer, size); }, block.get());
+            if (n > 0 && hasGzipMagic(block.get(), static_cast<size_t>(n))) {
+                gzip.reset(new GzipReader(input, block.get(), static_cast<size_t>(n), inflateThreads));
+                n = readStart([&](char* buffer, size_t size) { return gzip->read(buffer, size); }, block.get());
+            }
+            if (n > 0 && hasPackedMagic(block.get(), static_cast<uint64_t>(n))) {
+                std::cerr << "Error: Packed input needs file mode (an uncompressed input file, not a pipe)." << std::endl;
+                rejected = true;
+                return -1;
+            }
+            return n;
+        };
+        std::string pending;        // Start of a line cut by the end of a read.
+        bool overlong = false;
+        uint64_t sequence = 0;
+        uint64_t records = 0;
+        Slot* slot = nullptr;
+
+        auto publish = [&]() {
+            if (slot == nullptr) return;
+            ring.publish(sequence, FILLED);
+            state.produced.store(++sequence, std::memory_order_release);
+            slot = nullptr;
+        };
+
+        // Waiting here is the backpressure: the slot is only free once the writer is done with it.
+        bool sizeChecked = !rejectOtherGrids;
+        auto addRecord = [&](const char* line, size_t len) {
+            if (!sizeChecked) {
+                const size_t cells = static_cast<size_t>(std::count_if(line, line + len,
+                    [](char c) { return !std::isspace(static_cast<unsigned char>(c)); }));
+                const unsigned gridSize = gridSizeForCells(cells);
+                if (gridSize != 9) {
+                    std::cerr << "Error: " << gridSize << "x" << gridSize << " grids need file mode." << std::endl;
+                    state.failed.store(true, std::memory_order_relaxed);
+                    return false;
+                }
+                sizeChecked = cells != 0;
+            }
+            if (slot == nullptr) {
+                unsigned spins = 0;
+                while (!ring.reached(sequence, FREE)) {
+                    if (state.failed.load(std::memory_order_relaxed)) return false;
+                    backoff(spins);
+                }
+                slot = &ring.at(sequence);
+                slot->firstRecord = records;
+                slot->count = 0;
+            }
+            char scratch[PUZZLE_SIZE];
+            const char* puzzle = len <= MAX_LINE ? compactRecord(line, len, scratch) : nullptr;
+            if (puzzle != nullptr) std::memcpy(slot->cells.get() + slot->count * PUZZLE_SIZE, puzzle, PUZZLE_SIZE);
+            slot->valid[slot->count] = puzzle != nullptr;
+            records++;
+            if (++slot->count == slotRecords) publish();
+            return true;
+        };
+
+        auto appendPending = [&](const char* data, size_t len) {
+            if (overlong || pending.size() + len > MAX_LINE) overlong = true;
+            else pending.append(data, len);
+        };
+
+        bool ok = true;
+        for (;;) {
+            const long long n = readInput();
+            if (n < 0) {
+                if (!gzip && !rejected) std::cerr << "Error: Failed reading the input stream." << std::endl;
+                state.failed.store(true, std::memory_order_relaxed);
+                ok = false;
+                break;
+            }
+            if (n == 0) break;
+
+            const char* position = block.get();
+            const char* const end = position + n;
+            while (position < end) {
+                const char* newline = static_cast<const char*>(std::memchr(position, '\n', static_cast<size_t>(end - position)));
+                if (newline == nullptr) {
+                    appendPending(position, static_cast<size_t>(end - position));
+                    break;
+                }
+                const size_t len = static_cast<size_t>(newline - position);
+                if (pending.empty() && !overlong) {
+                    ok = addRecord(position, len);
+                } else {
+                    appendPending(position, len);
+                    ok = addRecord(pending.data(), overlong ? MAX_LINE + 1 : pending.size());
+                    pending.clear();
+                    overlong = false;
+                }
+                if (!ok) break;
+                position = newline + 1;
+            }
+            if (!ok) break;
+            // The input ran dry for now (a pipe or terminal): let the records read so far through.
+            if (static_cast<size_t>(n) < READ_BLOCK) publish();
+        }
+        // A last line without '\n' is still a record, as in file mode.
+        if (ok && (!pending.empty() || overlong)) addRecord(pending.data(), overlong ? MAX_LINE + 1 : pending.size());
+        if (ok) publish();
+        state.inputDone.store(true, std::memory_order_release);
+    }
+
+    void workerThread(SlotRing& ring, PipelineState& state, RecordSolver& records, GzipBlockCompressor* compressor,
+                      WorkerLoad& load, WorkerProgress& progress) {
+        for (;;) {
+            const uint64_t sequence = state.nextToSolve.fetch_add(1, std::memory_order_relaxed);
+            unsigned spins = 0;
+            while (!ring.reached(sequence, FILLED)) {
+                if (pastEnd(state, sequence) || state.failed.load(std::memory_order_relaxed)) return;
+                backoff(spins);
+            }
+
+            const auto slotStart = std::chrono::steady_clock::now();
+            Slot& slot = ring.at(sequence);
+            slot.output.clear();
+            records.begin(slot.firstRecord);
+            for (size_t i = 0; i < slot.count; ++i) {
+                records.process(slot.valid[i] ? slot.cells.get() + i * PUZZLE_SIZE : nullptr, slot.output);
+                progress.addProcessed();
+            }
+            records.finish(slot.output);
+            if (records.hasDeferred()) {
+                records.retryDeferred([&](uint64_t record, const char* data) {
+                    std::memcpy(&slot.output[(record - slot.firstRecord) * records.recordSize()], data, records.recordSize());
+                    return true;
+                });
+            }
+            // Compressing here, not in the writer, spreads it over all the workers.
+            if (compressor != nullptr) {
+                slot.compressed.clear();
+                if (!compressor->compress(slot.output.data(), slot.output.size(), slot.compressed)) {
+                    std::cerr << "Error: Failed compressing the output stream." << std::endl;
+                    state.failed.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            ring.publish(sequence, SOLVED);
+
+            load.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - slotStart).count();
+            load.chunks++;
+            load.records += slot.count;
+        }
+    }
+
+    void writerThread(std::FILE* output, bool compressed, SlotRing& ring, PipelineState& state, WorkerStats& stats) {
+        for (uint64_t sequence = 0;; ++sequence) {
+            unsigned spins = 0;
+            while (!ring.reached(sequence, SOLVED)) {
+                if (state.failed.load(std::memory_order_relaxed)) return;
+                if (pastEnd(state, sequence)) {
+                    if (!compressed) return;
+                    std::string end;
+                    GzipBlockCompressor::appendEndMember(end);
+                    if (!writeAll(output, end.data(), end.size())) {
+                        std::cerr << "Error: Failed writing the output stream." << std::endl;
+                        state.failed.store(true, std::memory_order_relaxed);
+                    }
+                    return;
+                }
+                backoff(spins);
+            }
+            Slot& slot = ring.at(sequence);
+            const std::string& bytes = compressed ? slot.compressed : slot.output;
+            bool written;
+            {
+                StatsTimer timer(stats.writeSeconds);
+                written = writeAll(output, bytes.data(), bytes.size());
+            }
+            if (!written) {
+                std::cerr << "Error: Failed writing the output stream." << std::endl;
+                state.failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            ring.recycle(sequence);
+        }
+    }
+
+}
+
+bool runStreamPipeline(std::FILE* input,
+                       std::FILE* output,
+                       ThreadPool& workers,
+                       const StreamOptions& streamOptions,
+                       const RecordMarkers& markers,
+                       const SolveOptions& options,
+                       std::vector<WorkerLoad>& loads,
+                       std::vector<WorkerStats>& stats,
+                       ProgressCounters& progress)
+{
+#if defined(_WIN32)
+    _setmode(_fileno(input), _O_BINARY);
+    _setmode(_fileno(output), _O_BINARY);
+#endif
+    const unsigned numWorkers = workers.size();
+    const size_t slotRecords = std::max<size_t>(1, streamOptions.slotRecords);
+    // Two slots per worker keep everyone busy; the rest absorb workers finishing out of order.
+    const size_t capacity = streamOptions.slots != 0 ? std::max<size_t>(2, streamOptions.slots) : 4 * size_t(numWorkers);
+    SlotRing ring(capacity, slotRecords);
+    PipelineState state;
+    loads.assign(numWorkers, WorkerLoad{});
+    stats.assign(numWorkers, WorkerStats{});
+
+    // The reader and the writer get threads of their own; the pool's threads are the workers.
+    WorkerStats writerStats;
+    const bool compressed = streamOptions.gzipLevel >= 0;
+    std::thread reader(readerThread, input, slotRecords, numWorkers, streamOptions.rejectOtherGrids, std::ref(ring),
+                       std::ref(state));
+    std::thread writer(writerThread, output, compressed, std::ref(ring), std::ref(state), std::ref(writerStats));
+    try {
+        workers.run([&](unsigned i) {
+            RecordSolver records(markers, options, stats[i], progress[i]);
+            std::unique_ptr<GzipBlockCompressor> compressor;
+            if (compressed) compressor.reset(new GzipBlockCompressor(streamOptions.gzipLevel));
+            workerThread(ring, state, records, compressor.get(), loads[i], progress[i]);
+        });
+    } catch (...) {
+        state.failed.store(true);
+        reader.join();
+        writer.join();
+        throw;
+    }
+    reader.join();
+    writer.join();
+    stats[0].merge(writerStats);
+    return !state.failed.load();
+}
+
+}
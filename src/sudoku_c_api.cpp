@@ -0,0 +1,95 @@
+#include "sudoku.h"
+#include "solver_pool.hpp"
+
+using SudokuApp::RecordStatus;
+using SudokuApp::SolverPool;
+
+struct sudoku_pool {
+    SolverPool pool;
+
+    explicit sudoku_pool(unsigned threads) : pool(threads) {}
+};
+
+namespace {
+
+    static_assert(sizeof(sudoku_status) == sizeof(RecordStatus), "status arrays are shared with the C++ API");
+    static_assert(SUDOKU_SOLVED == static_cast<int>(RecordStatus::Solved), "status values must match");
+    static_assert(SUDOKU_INVALID == static_cast<int>(RecordStatus::Invalid), "status values must match");
+    static_assert(SUDOKU_UNSOLVABLE == static_cast<int>(RecordStatus::Unsolvable), "status values must match");
+    static_assert(SUDOKU_ABORTED == static_cast<int>(RecordStatus::Aborted), "status values must match");
+
+    bool toSolveOptions(const sudoku_options* options, SudokuApp::SolveOptions& result) {
+        if (options == nullptr) return true;
+        if (options->size < sizeof(sudoku_options)) return false;
+        switch (options->engine) {
+            case SUDOKU_ENGINE_SCALAR: result.engine = SudokuApp::SolverEngine::Scalar; break;
+            case SUDOKU_ENGINE_BATCH: result.engine = SudokuApp::SolverEngine::Batch; break;
+            case SUDOKU_ENGINE_DLX: result.engine = SudokuApp::SolverEngine::Dlx; break;
+            default: return false;
+        }
+        result.budget.maxNodes = options->max_nodes;
+        result.budget.maxMillis = options->max_ms;
+        return true;
+    }
+
+    int solveOn(SolverPool& pool, const char* puzzles, size_t count, char* solutions,
+                sudoku_status* statuses, const sudoku_options* options)
+    {
+        SudokuApp::SolveOptions solveOptions;
+        if ((count != 0 && (puzzles == nullptr || solutions == nullptr)) || !toSolveOptions(options, solveOptions)) {
+            return SUDOKU_ERROR_ARGUMENT;
+        }
+        try {
+            pool.solveBatch(puzzles, count, solutions, reinterpret_cast<RecordStatus*>(statuses), solveOptions);
+        } catch (...) {
+            return SUDOKU_ERROR_INTERNAL;
+        }
+        return SUDOKU_OK;
+    }
+
+}
+
+extern "C" {
+
+int sudoku_api_version(void) {
+    return SUDOKU_API_VERSION;
+}
+
+void sudoku_options_init(sudoku_options* options) {
+    if (options == nullptr) return;
+    options->size = sizeof(sudoku_options);
+    options->engine = SUDOKU_ENGINE_SCALAR;
+    options->max_nodes = 0;
+    options->max_ms = 0;
+}
+
+int sudoku_solve_batch(const char* puzzles, size_t count, char* solutions,
+                       sudoku_status* statuses, const sudoku_options* options)
+{
+    try {
+        return solveOn(SolverPool::shared(), puzzles, count, solutions, statuses, options);
+    } catch (...) {
+        return SUDOKU_ERROR_INTERNAL;
+    }
+}
+
+sudoku_pool* sudoku_pool_create(unsigned threads) {
+    try {
+        return new sudoku_pool(threads);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void sudoku_pool_destroy(sudoku_pool* pool) {
+    delete pool;
+}
+
+int sudoku_pool_solve_batch(sudoku_pool* pool, const char* puzzles, size_t count, char* solutions,
+                            sudoku_status* statuses, const sudoku_options* options)
+{
+    if (pool == nullptr) return SUDOKU_ERROR_ARGUMENT;
+    return solveOn(pool->pool, puzzles, count, solutions, statuses, options);
+}
+
+}
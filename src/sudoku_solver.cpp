@@ -1,4 +1,5 @@
 #include "sudoku_solver.hpp"
+#include "packed_format.hpp"
 #include <cstring>           // For memset, memcpy
 #include <cstdint>           // For uint types (used implicitly via header, good practice)
 
@@ -24,6 +25,12 @@
          return portable_ctz(static_cast<unsigned int>(n));
     }
 
+    inline int portable_ctz64(uint64_t n) {
+        unsigned long index;
+        _BitScanForward64(&index, n);
+        return static_cast<int>(index);
+    }
+
 #elif defined(__GNUC__) || defined(__clang__)
     inline int portable_popcount(unsigned int n) {
         return __builtin_popcount(n);
@@ -39,158 +46,482 @@
         return __builtin_ctz(static_cast<unsigned int>(n));
     }
 
+    inline int portable_ctz64(uint64_t n) {
+        return __builtin_ctzll(n);
+    }
+
 #endif
 
 
 namespace SudokuApp {
 
-    struct CellInfo_Internal {
-        uint8_t row, col, box;
-    };
-    static constexpr CellInfo_Internal preCell_lookup[81] = {
-        {0,0,0}, {0,1,0}, {0,2,0}, {0,3,1}, {0,4,1}, {0,5,1}, {0,6,2}, {0,7,2}, {0,8,2},
-        {1,0,0}, {1,1,0}, {1,2,0}, {1,3,1}, {1,4,1}, {1,5,1}, {1,6,2}, {1,7,2}, {1,8,2},
-        {2,0,0}, {2,1,0}, {2,2,0}, {2,3,1}, {2,4,1}, {2,5,1}, {2,6,2}, {2,7,2}, {2,8,2},
-        {3,0,3}, {3,1,3}, {3,2,3}, {3,3,4}, {3,4,4}, {3,5,4}, {3,6,5}, {3,7,5}, {3,8,5},
-        {4,0,3}, {4,1,3}, {4,2,3}, {4,3,4}, {4,4,4}, {4,5,4}, {4,6,5}, {4,7,5}, {4,8,5},
-        {5,0,3}, {5,1,3}, {5,2,3}, {5,3,4}, {5,4,4}, {5,5,4}, {5,6,5}, {5,7,5}, {5,8,5},
-        {6,0,6}, {6,1,6}, {6,2,6}, {6,3,7}, {6,4,7}, {6,5,7}, {6,6,8}, {6,7,8}, {6,8,8},
-        {7,0,6}, {7,1,6}, {7,2,6}, {7,3,7}, {7,4,7}, {7,5,7}, {7,6,8}, {7,7,8}, {7,8,8},
-        {8,0,6}, {8,1,6}, {8,2,6}, {8,3,7}, {8,4,7}, {8,5,7}, {8,6,8}, {8,7,8}, {8,8,8}
+    /**
+     * @brief Compile-time tables of an N x N grid with `BoxRows` x `BoxCols` boxes: the
+     * row/column/box of every cell, the 3N units as lists of cells, and the peers of every
+     * cell (the other cells sharing a row, column or box).
+     */
+    template <unsigned BoxRows, unsigned BoxCols>
+    struct GridGeometry {
+        static constexpr unsigned N = BoxRows * BoxCols;
+        static constexpr unsigned CELLS = N * N;
+        static constexpr unsigned PEERS = 2 * (N - 1) + (BoxRows - 1) * (BoxCols - 1);
+        using CellIndex = typename BasicSudokuSolver<BoxRows, BoxCols>::CellIndex;
+
+        struct CellInfo { uint8_t row, col, box; };
+        struct CellTable { CellInfo cells[CELLS]; };
+        struct UnitTable { CellIndex cells[3 * N][N]; };
+        struct PeerTable { CellIndex cells[CELLS][PEERS]; };
+
+        static constexpr unsigned boxOf(unsigned row, unsigned col) { return (row / BoxRows) * BoxRows + col / BoxCols; }
+
+        static constexpr CellTable makeCellTable() {
+            CellTable table{};
+            for (unsigned cell = 0; cell < CELLS; ++cell) {
+                const unsigned row = cell / N, col = cell % N;
+                table.cells[cell] = {static_cast<uint8_t>(row), static_cast<uint8_t>(col), static_cast<uint8_t>(boxOf(row, col))};
+            }
+            return table;
+        }
+
+        // Rows first, then columns, then boxes (box u: band u / BoxRows, stack u % BoxRows).
+        static constexpr UnitTable makeUnitTable() {
+            UnitTable table{};
+            for (unsigned u = 0; u < N; ++u) {
+                for (unsigned k = 0; k < N; ++k) {
+                    table.cells[u][k] = static_cast<CellIndex>(u * N + k);
+                    table.cells[N + u][k] = static_cast<CellIndex>(k * N + u);
+                    const unsigned row = (u / BoxRows) * BoxRows + k / BoxCols;
+                    const unsigned col = (u % BoxRows) * BoxCols + k % BoxCols;
+                    table.cells[2 * N + u][k] = static_cast<CellIndex>(row * N + col);
+                }
+            }
+            return table;
+        }
+
+        // Peers in increasing cell order, the order the search visits them in.
+        static constexpr PeerTable makePeerTable() {
+            PeerTable table{};
+            for (unsigned cell = 0; cell < CELLS; ++cell) {
+                const unsigned row = cell / N, col = cell % N, box = boxOf(row, col);
+                unsigned count = 0;
+                for (unsigned other = 0; other < CELLS; ++other) {
+                    const unsigned r = other / N, c = other % N;
+                    if (other != cell && (r == row || c == col || boxOf(r, c) == box)) {
+                        table.cells[cell][count++] = static_cast<CellIndex>(other);
+                    }
+                }
+            }
+            return table;
+        }
+
+        static constexpr CellTable cellTable = makeCellTable();
+        static constexpr UnitTable unitTable = makeUnitTable();
+        static constexpr PeerTable peerTable = makePeerTable();
     };
 
+    // Sizes up to 9 use only '1'-'9', so reading a grid cell back stays a subtraction there.
+    template <unsigned N>
+    inline int symbolValue(char c) {
+        if (N <= 9 || c <= '9') return c - '0';
+        return c - 'A' + 10;
+    }
+
+    /** @brief The digit a puzzle character stands for: 0 for empty cells, above N for bad symbols. */
+    template <unsigned N>
+    inline unsigned parseSymbol(char c) {
+        if (c >= '1' && c <= '9') return static_cast<unsigned>(c - '0');
+        if (N <= 9) return 0;
+        if (c >= 'A' && c <= 'Z') return static_cast<unsigned>(c - 'A' + 10);
+        if (c >= 'a' && c <= 'z') return static_cast<unsigned>(c - 'a' + 10);
+        return 0;
+    }
+
+    template <unsigned W>
+    inline bool anyCell(const uint64_t (&set)[W]) {
+        uint64_t any = 0;
+        for (unsigned w = 0; w < W; ++w) any |= set[w];
+        return any != 0;
+    }
 
-    bool SudokuSolver::initialize(const char* puzzle_data, size_t len) {
-        if (len != 81 || puzzle_data == nullptr) return false;
+    /** @brief Lowest cell of a non-empty cell set, or -1. */
+    template <unsigned W>
+    inline int firstCell(const uint64_t (&set)[W]) {
+        for (unsigned w = 0; w < W; ++w) {
+            if (set[w]) return static_cast<int>(64 * w) + portable_ctz64(set[w]);
+        }
+        return -1;
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    inline typename BasicSudokuSolver<BoxRows, BoxCols>::Mask BasicSudokuSolver<BoxRows, BoxCols>::candidates(int cell) const {
+        constexpr Mask FULL = static_cast<Mask>(((uint64_t(1) << DIGITS) - 1) << 1);
+        const auto& info = GridGeometry<BoxRows, BoxCols>::cellTable.cells[cell];
+        return static_cast<Mask>(~(rows[info.row] | cols[info.col] | boxes[info.box]) & FULL);
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    inline void BasicSudokuSolver<BoxRows, BoxCols>::setCandidates(int cell, Mask possible) {
+        const uint64_t bit = 1ull << (cell & 63);
+        countBuckets[portable_popcount(cand[cell])][cell >> 6] &= ~bit;
+        countBuckets[portable_popcount(possible)][cell >> 6] |= bit;
+        cand[cell] = possible;
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    bool BasicSudokuSolver<BoxRows, BoxCols>::canPlace(int cell, int num) const {
+        if (cell < 0 || cell >= static_cast<int>(CELLS)) return false;
+        const Mask mask = static_cast<Mask>(Mask(1) << num);
+        const auto& info = GridGeometry<BoxRows, BoxCols>::cellTable.cells[cell];
+        return !((rows[info.row] | cols[info.col] | boxes[info.box]) & mask);
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    bool BasicSudokuSolver<BoxRows, BoxCols>::initialize(const char* puzzle_data, size_t len) {
+        if (len != CELLS || puzzle_data == nullptr) return false;
         emptyCount = 0;
+        trailSize = 0;
         memset(rows, 0, sizeof(rows));
         memset(cols, 0, sizeof(cols));
         memset(boxes, 0, sizeof(boxes));
-        memcpy(grid, puzzle_data, 81);
-        memset(position, 81, sizeof(position));
+        memset(cand, 0, sizeof(cand));
+        memset(countBuckets, 0, sizeof(countBuckets));
         bool initial_valid = true;
-        for (int i = 0; i < 81; ++i) {
-            int num = 0;
-            if (grid[i] >= '1' && grid[i] <= '9') { num = grid[i] - '0'; }
-            else { grid[i] = '0'; }
+        for (unsigned i = 0; i < CELLS; ++i) {
+            const unsigned num = parseSymbol<DIGITS>(puzzle_data[i]);
+            if (num > DIGITS) {
+                initial_valid = false;
+                grid[i] = '0';
+                emptyCount++;
+                continue;
+            }
             if (num != 0) {
-                const uint16_t mask = 1 << num;
-                const auto& info = preCell_lookup[i];
+                grid[i] = symbol(num);
+                const Mask mask = static_cast<Mask>(Mask(1) << num);
+                const auto& info = GridGeometry<BoxRows, BoxCols>::cellTable.cells[i];
                 if ((rows[info.row] & mask) || (cols[info.col] & mask) || (boxes[info.box] & mask)) {
                     initial_valid = false; // Keep checking or return false;
                 }
                 rows[info.row] |= mask; cols[info.col] |= mask; boxes[info.box] |= mask;
             } else {
-                if (emptyCount < 81) {
-                    emptyCells[emptyCount] = static_cast<uint8_t>(i);
-                    position[i] = static_cast<uint8_t>(emptyCount);
-                    emptyCount++;
-                } else { return false; }
+                grid[i] = '0';
+                emptyCount++;
             }
         }
+        for (unsigned i = 0; i < CELLS; ++i) {
+            if (grid[i] != '0') continue;
+            cand[i] = candidates(i);
+            countBuckets[portable_popcount(cand[i])][i >> 6] |= 1ull << (i & 63);
+        }
         return initial_valid;
     }
 
 
-    bool SudokuSolver::solve() {
-        for(int i=0; i<9; ++i) {
-            if(portable_popcount(rows[i] & 0x3FEu) != portable_popcount(rows[i])) return false;
-            if(portable_popcount(cols[i] & 0x3FEu) != portable_popcount(cols[i])) return false;
-            if(portable_popcount(boxes[i] & 0x3FEu) != portable_popcount(boxes[i])) return false;
+    template <unsigned BoxRows, unsigned BoxCols>
+    bool BasicSudokuSolver<BoxRows, BoxCols>::initializePacked(const uint8_t* packed) {
+        if constexpr (CELLS != 81) {
+            (void)packed;
+            return false;
+        } else {
+            uint8_t cells[81];
+            if (!unpackCells(packed, cells)) return false;
+            emptyCount = 0;
+            trailSize = 0;
+            memset(rows, 0, sizeof(rows));
+            memset(cols, 0, sizeof(cols));
+            memset(boxes, 0, sizeof(boxes));
+            memset(cand, 0, sizeof(cand));
+            memset(countBuckets, 0, sizeof(countBuckets));
+            bool initial_valid = true;
+            for (int i = 0; i < 81; ++i) {
+                const int num = cells[i];
+                grid[i] = static_cast<char>('0' + num);
+                if (num == 0) {
+                    emptyCount++;
+                    continue;
+                }
+                const Mask mask = static_cast<Mask>(1 << num);
+                const auto& info = GridGeometry<BoxRows, BoxCols>::cellTable.cells[i];
+                if ((rows[info.row] | cols[info.col] | boxes[info.box]) & mask) initial_valid = false;
+                rows[info.row] |= mask; cols[info.col] |= mask; boxes[info.box] |= mask;
+            }
+            for (int i = 0; i < 81; ++i) {
+                if (cells[i] != 0) continue;
+                cand[i] = candidates(i);
+                countBuckets[portable_popcount(cand[i])][i >> 6] |= 1ull << (i & 63);
+            }
+            return initial_valid;
+        }
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    SolveResult BasicSudokuSolver<BoxRows, BoxCols>::solve() {
+        constexpr Mask FULL = static_cast<Mask>(((uint64_t(1) << DIGITS) - 1) << 1);
+        aborted = false;
+        SUDOKU_STAT(stats = SearchStats());
+        for (unsigned i = 0; i < DIGITS; ++i) {
+            if(portable_popcount(static_cast<Mask>(rows[i] & FULL)) != portable_popcount(rows[i])) return SolveResult::Unsolvable;
+            if(portable_popcount(static_cast<Mask>(cols[i] & FULL)) != portable_popcount(cols[i])) return SolveResult::Unsolvable;
+            if(portable_popcount(static_cast<Mask>(boxes[i] & FULL)) != portable_popcount(boxes[i])) return SolveResult::Unsolvable;
         }
-        return solveInternal();
+        tracker.start(budget);
+#if SUDOKU_ITERATIVE_SEARCH
+        const bool solved = solveIterative();
+#else
+        const bool solved = solveInternal();
+#endif
+        if (solved) return SolveResult::Solved;
+        return aborted ? SolveResult::Aborted : SolveResult::Unsolvable;
     }
 
 
-    const char* SudokuSolver::getSolution() const {
+    template <unsigned BoxRows, unsigned BoxCols>
+    uint64_t BasicSudokuSolver<BoxRows, BoxCols>::countSolutions(uint64_t limit) {
+        constexpr Mask FULL = static_cast<Mask>(((uint64_t(1) << DIGITS) - 1) << 1);
+        aborted = false;
+        SUDOKU_STAT(stats = SearchStats());
+        if (limit == 0) return 0;
+        for (unsigned i = 0; i < DIGITS; ++i) {
+            if(portable_popcount(static_cast<Mask>(rows[i] & FULL)) != portable_popcount(rows[i])) return 0;
+            if(portable_popcount(static_cast<Mask>(cols[i] & FULL)) != portable_popcount(cols[i])) return 0;
+            if(portable_popcount(static_cast<Mask>(boxes[i] & FULL)) != portable_popcount(boxes[i])) return 0;
+        }
+        tracker.start(budget);
+        const uint64_t found = searchIterative(limit);
+        // Below the limit the search ran to exhaustion past the first solution; put it back.
+        if (found > 0 && found < limit) memcpy(grid, firstSolution, sizeof(grid));
+        return found;
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    const char* BasicSudokuSolver<BoxRows, BoxCols>::getSolution() const {
         return grid;
     }
 
 
-    void SudokuSolver::place(int cell, int num) {
-        if (cell < 0 || cell >= 81 || num < 1 || num > 9) return;
-        const auto& info = preCell_lookup[cell];
-        const uint16_t mask = 1 << num;
+    template <unsigned BoxRows, unsigned BoxCols>
+    void BasicSudokuSolver<BoxRows, BoxCols>::place(int cell, int num) {
+        if (cell < 0 || cell >= static_cast<int>(CELLS) || num < 1 || num > static_cast<int>(DIGITS)) return;
+        const auto& info = GridGeometry<BoxRows, BoxCols>::cellTable.cells[cell];
+        const Mask mask = static_cast<Mask>(Mask(1) << num);
         rows[info.row] |= mask; cols[info.col] |= mask; boxes[info.box] |= mask;
-        grid[cell] = '0' + num;
-        if (emptyCount > 0) {
-            const int pos = position[cell];
-            if (pos < emptyCount && pos >= 0) {
-                const uint8_t last_cell_index = emptyCells[emptyCount - 1];
-                if(last_cell_index < 81) {
-                    emptyCells[pos] = last_cell_index;
-                    position[last_cell_index] = pos;
-                }
-                position[cell] = 81;
-            }
-            emptyCount--;
+        grid[cell] = symbol(num);
+        countBuckets[portable_popcount(cand[cell])][cell >> 6] &= ~(1ull << (cell & 63));
+        cand[cell] = 0;
+        emptyCount--;
+
+        const CellIndex* peers = GridGeometry<BoxRows, BoxCols>::peerTable.cells[cell];
+        for (unsigned k = 0; k < PEERS; ++k) {
+            const int peer = peers[k];
+            if (cand[peer] & mask) setCandidates(peer, static_cast<Mask>(cand[peer] & ~mask));
         }
     }
 
 
-    void SudokuSolver::remove(int cell, int num) {
-        if (cell < 0 || cell >= 81 || num < 1 || num > 9) return;
-        const auto& info = preCell_lookup[cell];
-        const uint16_t mask = ~(1 << num);
+    template <unsigned BoxRows, unsigned BoxCols>
+    void BasicSudokuSolver<BoxRows, BoxCols>::remove(int cell, int num) {
+        if (cell < 0 || cell >= static_cast<int>(CELLS) || num < 1 || num > static_cast<int>(DIGITS)) return;
+        const auto& info = GridGeometry<BoxRows, BoxCols>::cellTable.cells[cell];
+        const Mask mask = static_cast<Mask>(~(Mask(1) << num));
         rows[info.row] &= mask; cols[info.col] &= mask; boxes[info.box] &= mask;
         grid[cell] = '0';
-        if (emptyCount < 81) {
-            position[cell] = emptyCount;
-            emptyCells[emptyCount] = static_cast<uint8_t>(cell);
-            emptyCount++;
-        }
-    }
-
-
-    int SudokuSolver::findMRV() const {
-        int minCount = 10;
-        int bestCell = -1;
-        for (int i = 0; i < emptyCount; ++i) {
-            const int cell = emptyCells[i];
-            if (cell < 0 || cell >= 81) continue;
-            const auto& info = preCell_lookup[cell];
-            const uint16_t used = rows[info.row] | cols[info.col] | boxes[info.box];
-            // Use the portable popcount wrapper
-            const int count = portable_popcount(static_cast<uint16_t>(~used & 0x3FEu));
-
-            if (count == 0) return -1;
-            if (count < minCount) {
-                minCount = count;
-                bestCell = cell;
-                if (minCount == 1) break;
+        emptyCount++;
+        cand[cell] = candidates(cell);
+        countBuckets[portable_popcount(cand[cell])][cell >> 6] |= 1ull << (cell & 63);
+
+        // A peer gets `num` back only if none of its own units still holds it.
+        const CellIndex* peers = GridGeometry<BoxRows, BoxCols>::peerTable.cells[cell];
+        for (unsigned k = 0; k < PEERS; ++k) {
+            const int peer = peers[k];
+            if (grid[peer] != '0') continue;
+            const Mask possible = candidates(peer);
+            if (possible != cand[peer]) setCandidates(peer, possible);
+        }
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    int BasicSudokuSolver<BoxRows, BoxCols>::findMRV() const {
+        if (anyCell(countBuckets[0])) return -1;
+        for (unsigned count = 1; count <= DIGITS; ++count) {
+            const int cell = firstCell(countBuckets[count]);
+            if (cell >= 0) return cell;
+        }
+        return -1;
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    void BasicSudokuSolver<BoxRows, BoxCols>::undoTo(int mark) {
+        while (trailSize > mark) {
+            const int cell = trail[--trailSize];
+            remove(cell, symbolValue<DIGITS>(grid[cell]));
+        }
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    bool BasicSudokuSolver<BoxRows, BoxCols>::propagate() {
+        constexpr Mask FULL = static_cast<Mask>(((uint64_t(1) << DIGITS) - 1) << 1);
+        for (;;) {
+            // Naked singles straight from the count buckets; a cell with no candidates is a dead end.
+            for (;;) {
+                if (anyCell(countBuckets[0])) return false;
+                const int cell = firstCell(countBuckets[1]);
+                if (cell < 0) break;
+                place(cell, portable_ctz(cand[cell]));
+                trail[trailSize++] = static_cast<CellIndex>(cell);
+            }
+            if (emptyCount == 0) return true;
+
+            // Hidden singles: a digit that fits exactly one empty cell of a unit goes there.
+            const int before = trailSize;
+            for (unsigned u = 0; u < 3 * DIGITS; ++u) {
+                const CellIndex* cells = GridGeometry<BoxRows, BoxCols>::unitTable.cells[u];
+                Mask once = 0, twice = 0;
+                for (unsigned k = 0; k < DIGITS; ++k) {
+                    const Mask possible = cand[cells[k]];
+                    twice |= once & possible;
+                    once |= possible;
+                }
+                const Mask placed = u < DIGITS ? rows[u] : (u < 2 * DIGITS ? cols[u - DIGITS] : boxes[u - 2 * DIGITS]);
+                if (((once | placed) & FULL) != FULL) return false;
+
+                Mask hidden = static_cast<Mask>(once & ~twice);
+                while (hidden) {
+                    const int num = portable_ctz(hidden);
+                    hidden &= hidden - 1;
+                    int target = -1;
+                    for (unsigned k = 0; k < DIGITS; ++k) {
+                        if (cand[cells[k]] & (Mask(1) << num)) { target = cells[k]; break; }
+                    }
+                    // The only cell for this digit was just taken by another hidden single.
+                    if (target == -1) return false;
+                    place(target, num);
+                    trail[trailSize++] = static_cast<CellIndex>(target);
+                }
             }
+            if (trailSize == before) return true;
         }
-         if (bestCell == -1 && emptyCount > 0) {
-             bestCell = emptyCells[0];
-         }
-        return bestCell;
     }
 
 
-    bool SudokuSolver::solveInternal() {
+    template <unsigned BoxRows, unsigned BoxCols>
+    int BasicSudokuSolver<BoxRows, BoxCols>::branchCell() {
+        if (!propagate() || emptyCount == 0) return -1;
+        return findMRV();
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    void BasicSudokuSolver<BoxRows, BoxCols>::assume(int cell, int num) {
+        place(cell, num);
+        trail[trailSize++] = static_cast<CellIndex>(cell);
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    bool BasicSudokuSolver<BoxRows, BoxCols>::solveInternal() {
+        if (tracker.step()) { aborted = true; return false; }
+        SUDOKU_STAT(stats.nodes++);
+        const int mark = trailSize;
+        if (!propagate()) { undoTo(mark); return false; }
         if (emptyCount == 0) return true;
-        const int cell = findMRV();
-        if (cell == -1) return false;
-        if (cell < 0 || cell >= 81) return false;
 
-        const auto& info = preCell_lookup[cell];
-        const uint16_t used = rows[info.row] | cols[info.col] | boxes[info.box];
-        uint16_t possible = ~used & 0x3FEu;
+        const int cell = findMRV();
+        if (cell < 0 || cell >= static_cast<int>(CELLS)) { undoTo(mark); return false; }
 
+        Mask possible = cand[cell];
         while (possible) {
             const int num = portable_ctz(possible);
+            place(cell, num);
+            trail[trailSize++] = static_cast<CellIndex>(cell);
+            SUDOKU_STAT(stats.guesses++);
+            if (solveInternal()) { return true; }
+            if (aborted) return false;  // Unwinding only; the next initialize resets the state.
+            undoTo(trailSize - 1);
+            SUDOKU_STAT(stats.backtracks++);
+            possible &= possible - 1;
+        }
+        undoTo(mark);
+        return false;
+    }
 
-            if (num < 1 || num > 9) {
-                 possible &= (possible - 1);
-                 continue;
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    bool BasicSudokuSolver<BoxRows, BoxCols>::solveIterative() {
+        return searchIterative(1) != 0;
+    }
+
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    uint64_t BasicSudokuSolver<BoxRows, BoxCols>::searchIterative(uint64_t limit) {
+        // Same traversal as solveInternal. A frame is pushed when a node branches; the trail
+        // entry right below a child's mark is always the parent's guess. A solution below the
+        // limit is counted and then backtracked over like a dead end.
+        uint64_t found = 0;
+        int depth = 0;
+        bool entering = true;
+        for (;;) {
+            if (entering) {
+                if (tracker.step()) { aborted = true; return found; }
+                SUDOKU_STAT(stats.nodes++);
+                const int mark = trailSize;
+                bool expand = propagate();
+                if (expand && emptyCount == 0) {
+                    if (++found >= limit) return found;
+                    if (found == 1) memcpy(firstSolution, grid, sizeof(grid));
+                    expand = false;
+                }
+                if (expand) {
+                    const int cell = findMRV();
+                    if (cell < 0 || cell >= static_cast<int>(CELLS)) return found;
+                    stackCell[depth] = static_cast<CellIndex>(cell);
+                    stackMark[depth] = static_cast<CellIndex>(mark);
+                    stackRemaining[depth] = cand[cell];
+                } else {
+                    // Nothing left to explore at the root: leave the state as it is, the next
+                    // initialize resets it anyway.
+                    if (depth == 0) return found;
+                    undoTo(mark);
+                    --depth;
+                    undoTo(trailSize - 1);
+                    SUDOKU_STAT(stats.backtracks++);
+                }
             }
 
+            Mask& remaining = stackRemaining[depth];
+            if (remaining == 0) {
+                if (depth == 0) return found;
+                undoTo(stackMark[depth]);
+                --depth;
+                undoTo(trailSize - 1);
+                SUDOKU_STAT(stats.backtracks++);
+                entering = false;
+                continue;
+            }
+
+            const int cell = stackCell[depth];
+            const int num = portable_ctz(remaining);
+            remaining &= remaining - 1;
             place(cell, num);
-            if (solveInternal()) { return true; }
-            remove(cell, num);
-            possible &= ~(1 << num);
+            trail[trailSize++] = static_cast<CellIndex>(cell);
+            SUDOKU_STAT(stats.guesses++);
+            ++depth;
+            entering = true;
         }
-        return false;
     }
 
-}
\ No newline at end of file
+
+    // The sizes the library offers; each gets its own tables and fully inlined search.
+    template class BasicSudokuSolver<2, 2>;
+    template class BasicSudokuSolver<3, 3>;
+    template class BasicSudokuSolver<4, 4>;
+    template class BasicSudokuSolver<5, 5>;
+
+}
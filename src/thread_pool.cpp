@@ -0,0 +1,82 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace SudokuApp {
+
+ThreadPool::ThreadPool(unsigned threads) : workers(std::max(1u, threads)) {
+    start();
+}
+
+ThreadPool::ThreadPool(const std::vector<LogicalCpu>& placement, bool pin) : workers(std::max<size_t>(1, placement.size())) {
+    for (size_t i = 0; i < placement.size(); ++i) {
+        workers[i].cpu = placement[i];
+        workers[i].pin = pin;
+    }
+    start();
+}
+
+// Waits until every worker has pinned itself, so `pinned()` is settled once the constructor returns.
+void ThreadPool::start() {
+    busy = size();
+    for (unsigned i = 0; i < size(); ++i) workers[i].thread = std::thread(&ThreadPool::workerLoop, this, i);
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return busy == 0; });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.thread.join();
+}
+
+void ThreadPool::run(const std::function<void(unsigned)>& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &job;
+        busy = size();
+        failure = nullptr;
+        ++generation;
+    }
+    wake.notify_all();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return busy == 0; });
+    task = nullptr;
+    if (failure) std::rethrow_exception(failure);
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    Worker& self = workers[index];
+    const bool pinned = self.pin && pinCurrentThread(self.cpu.id);
+    uint64_t seen = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        self.pinned = pinned;
+        if (--busy == 0) idle.notify_one();
+    }
+    for (;;) {
+        const std::function<void(unsigned)>* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            job = task;
+        }
+        std::exception_ptr error;
+        try {
+            (*job)(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error && !failure) failure = error;
+        if (--busy == 0) idle.notify_one();
+    }
+}
+
+}
@@ -1,5 +1,5 @@
 #include "worker.hpp"
-#include "sudoku_solver.hpp"
+#include "run_stats.hpp"
 
 #include <fstream>
 #include <string>
@@ -7,100 +7,425 @@
 #include <atomic>
 #include <iostream>
 #include <vector>
+#include <cstring>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <type_traits>
 
 namespace SudokuApp {
 
-void solverWorker(
-    size_t workerId,
-    const std::string& inputFilename,
-    const std::string& tempFilePrefix,
-    size_t startLine,
-    size_t endLine,
-    std::atomic<size_t>& solvedCounter,
-    std::atomic<size_t>& processedCounter,
-    std::atomic<bool>& errorFlag)
-{
-    thread_local SudokuSolver solver;
+namespace {
 
-    std::string tempOutputFilename = tempFilePrefix + std::to_string(workerId) + ".tmp";
+    // Resident input pages are handed back to the kernel every RELEASE_WINDOW bytes.
+    constexpr uint64_t RELEASE_WINDOW = 8ull << 20;
 
-    std::ifstream inputFile(inputFilename);
-    if (!inputFile) {
-        std::cerr << "Worker " << workerId << " Error: Cannot open input file: " << inputFilename << std::endl;
-        errorFlag.store(true, std::memory_order_relaxed);
-        return;
-    }
+    /**
+     * @brief Calls `process(record, len)` for every line of the text chunk `range` (without its
+     * '\n'), zero-copy from `mappedInput` or, if that is null, through `inputFile`.
+     * @return false (with an error on stderr) if the input could not be read.
+     */
+    template <typename Process>
+    bool forEachLine(size_t workerId, const std::string& inputFilename, const MappedFile* mappedInput,
+                     std::ifstream& inputFile, std::string& line, ByteRange range, Process&& process)
+    {
+        if (mappedInput != nullptr) {
+            const char* const base = mappedInput->data();
+            uint64_t position = range.begin;
+            uint64_t released = range.begin;
 
-    std::ofstream tempOutputFile(tempOutputFilename, std::ios::binary);
-    if (!tempOutputFile) {
-        std::cerr << "Worker " << workerId << " Error: Cannot open temporary output file: " << tempOutputFilename << std::endl;
-        errorFlag.store(true, std::memory_order_relaxed);
-        inputFile.close();
-        return;
-    }
+            while (position < range.end) {
+                const char* lineStart = base + position;
+                const size_t remaining = static_cast<size_t>(range.end - position);
+                const char* newline = static_cast<const char*>(std::memchr(lineStart, '\n', remaining));
+                const size_t len = newline ? static_cast<size_t>(newline - lineStart) : remaining;
 
-    std::string line;
-    size_t currentLine = 0;
+                process(lineStart, len);
+                position += len + 1;
+
+                if (position - released >= RELEASE_WINDOW) {
+                    mappedInput->release(released, position);
+                    released = position;
+                }
+            }
+            mappedInput->release(released, range.end);
+            return true;
+        }
 
-    std::string outputBuffer;
-    constexpr size_t BATCH_SIZE = 150;
-    outputBuffer.reserve(BATCH_SIZE * 81);
-    size_t resultsInBatch = 0;
+        inputFile.clear();
+        inputFile.seekg(static_cast<std::streamoff>(range.begin));
+        if (!inputFile) {
+            std::cerr << "Worker " << workerId << " Error: Cannot seek to offset " << range.begin << " in: " << inputFilename << std::endl;
+            return false;
+        }
 
-    while (currentLine < startLine && std::getline(inputFile, line)) {
-        currentLine++;
+        uint64_t position = range.begin;
+        while (position < range.end && std::getline(inputFile, line)) {
+            position += line.size() + 1;
+            process(line.data(), line.size());
+        }
+        if (inputFile.bad()) {
+            std::cerr << "Worker " << workerId << " Error: Input file stream error." << std::endl;
+            return false;
+        }
+        return true;
     }
 
-    while (currentLine < endLine && std::getline(inputFile, line)) {
-        processedCounter.fetch_add(1, std::memory_order_relaxed);
-        line.erase(std::remove_if(line.begin(), line.end(),
-                   [](unsigned char c){ return c == '\r' || c == '\n' || std::isspace(c); }), line.end());
+    /**
+     * @brief The part of `RecordSolver`'s interface the chunk loop uses, for the scalar solver of
+     * BoxRows*BoxCols x BoxRows*BoxCols grids: text records of N*N cells + '\n'.
+     *
+     * Aborted puzzles are retried right away, so nothing is ever deferred.
+     */
+    template <unsigned BoxRows, unsigned BoxCols>
+    class GridRecordSolver {
+    public:
+        using Solver = BasicSudokuSolver<BoxRows, BoxCols>;
+        static constexpr size_t CELLS = Solver::CELLS;
+
+        GridRecordSolver(const RecordMarkers& markers, const SolveOptions& options, WorkerStats& stats, WorkerProgress& progress)
+            : markers(markers), options(options), stats(stats), progress(progress)
+        {
+            solver.setBudget(options.budget);
+        }
+
+        size_t recordSize() const { return CELLS + 1; }
+        void begin(uint64_t) {}
+        void finish(std::string&) {}
+        bool hasDeferred() const { return false; }
+        size_t deferredCount() const { return 0; }
 
-        bool was_solved = false;
+        template <typename Write>
+        bool retryDeferred(const Write&) { return true; }
 
-        if (line.size() == 81) {
-            if (solver.initialize(line.data(), line.size())) {
-                if (solver.solve()) {
-                    was_solved = true;
+        // Blanks are dropped like in 9x9 records; a record is well-formed with exactly N*N cells left.
+        void processLine(const char* record, size_t len, std::string& out) {
+            size_t count = 0;
+            for (size_t i = 0; i < len && count <= CELLS; ++i) {
+                const unsigned char c = static_cast<unsigned char>(record[i]);
+                if (std::isspace(c)) continue;
+                if (count < CELLS) cells[count] = static_cast<char>(c);
+                count++;
+            }
+            RecordStatus status = RecordStatus::Invalid;
+            if (count == CELLS) {
+                status = solveCells();
+                if (status == RecordStatus::Aborted && options.retryAborted) {
+                    solver.setBudget(options.retryBudget);
+                    status = solveCells();
+                    solver.setBudget(options.budget);
                 }
+                SUDOKU_STAT(if (status != RecordStatus::Invalid) stats.search += solver.searchStats());
+            }
+            if (status == RecordStatus::Solved) {
+                progress.addSolved();
+                out.append(solver.getSolution(), CELLS);
+            } else {
+                out.append(CELLS, markers.forStatus(status)[0]);
             }
+            out.push_back('\n');
         }
 
-        if (was_solved) {
-            outputBuffer.append(solver.getSolution(), 81);
-            outputBuffer.push_back('\n');
-            resultsInBatch++;
-            solvedCounter.fetch_add(1, std::memory_order_relaxed);
-
-            if (resultsInBatch >= BATCH_SIZE) {
-                tempOutputFile.write(outputBuffer.data(), outputBuffer.size());
-                if (!tempOutputFile) {
-                    std::cerr << "Worker " << workerId << " Error: Failed writing to temp file: " << tempOutputFilename << std::endl;
-                    errorFlag.store(true, std::memory_order_relaxed);
+    private:
+        RecordStatus solveCells() {
+            StatsTimer timer(stats.solveSeconds, &stats.solveLatency);
+            if (!solver.initialize(cells, CELLS)) return RecordStatus::Invalid;
+            return toRecordStatus(solver.solve());
+        }
+
+        const RecordMarkers& markers;
+        const SolveOptions& options;
+        WorkerStats& stats;
+        WorkerProgress& progress;
+        Solver solver;
+        char cells[CELLS];
+    };
+
+    void processLine(RecordSolver& records, const char* record, size_t len, std::string& out) {
+        char cleaned[PUZZLE_SIZE];
+        records.process(compactRecord(record, len, cleaned), out);
+    }
+
+    template <unsigned BoxRows, unsigned BoxCols>
+    void processLine(GridRecordSolver<BoxRows, BoxCols>& records, const char* record, size_t len, std::string& out) {
+        records.processLine(record, len, out);
+    }
+
+    /**
+     * @brief The chunk loop of `solverWorker` and `gridSolverWorker`: claims chunks, solves their
+     * records with `records` (a `RecordSolver` or a `GridRecordSolver`), writes them at their
+     * final offset, journals finished chunks and retries deferred records at the end.
+     */
+    template <typename Records>
+    void solveChunks(
+        size_t workerId,
+        const std::string& inputFilename,
+        const MappedFile* mappedInput,
+        size_t packedRecordSize,
+        const PositionalOutputFile& output,
+        RunJournal* journal,
+        const std::vector<InputChunk>& chunks,
+        ChunkScheduler& scheduler,
+        size_t domain,
+        Records& records,
+        WorkerLoad& load,
+        WorkerStats& stats,
+        WorkerProgress& progress,
+        std::atomic<bool>& errorFlag)
+    {
+        const size_t recordSize = records.recordSize();
+        std::string outputBuffer;
+        constexpr size_t BATCH_SIZE = 150;
+        outputBuffer.reserve((BATCH_SIZE + BatchSolver::LANES) * recordSize);
+        uint64_t batchFirstRecord = 0;
+
+        // The buffer holds consecutive records, so it lands in the output with a single positional write.
+        auto flushBatch = [&]() {
+            if (outputBuffer.empty()) return;
+            StatsTimer timer(stats.writeSeconds);
+            if (!output.writeAt(batchFirstRecord * recordSize, outputBuffer.data(), outputBuffer.size())) {
+                std::cerr << "Worker " << workerId << " Error: Failed writing records at " << batchFirstRecord << " to output file." << std::endl;
+                errorFlag.store(true, std::memory_order_relaxed);
+            }
+            batchFirstRecord += outputBuffer.size() / recordSize;
+            outputBuffer.clear();
+        };
+
+        // `record` excludes the '\n'. Every record appends exactly one output record, which keeps
+        // the output aligned.
+        auto processRecord = [&](const char* record, size_t len) {
+            progress.addProcessed();
+            processLine(records, record, len, outputBuffer);
+            if (outputBuffer.size() >= BATCH_SIZE * recordSize) flushBatch();
+        };
+
+        std::ifstream inputFile;
+        if (mappedInput == nullptr) {
+            inputFile.open(inputFilename, std::ios::binary);
+            if (!inputFile) {
+                std::cerr << "Worker " << workerId << " Error: Cannot open input file: " << inputFilename << std::endl;
+                errorFlag.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+        std::string line;
+        // Chunks with records waiting for the retry pass; they are journaled after it.
+        std::vector<size_t> retriedChunks;
+
+        size_t chunkIndex = 0;
+        while (!errorFlag.load(std::memory_order_relaxed) && scheduler.claim(chunkIndex, domain)) {
+            if (journal != nullptr && journal->completed(chunkIndex)) continue;
+            const auto chunkStart = std::chrono::steady_clock::now();
+            const InputChunk& chunk = chunks[chunkIndex];
+            const ByteRange range = chunk.range;
+            const size_t deferredBefore = records.deferredCount();
+            batchFirstRecord = chunk.firstRecord;
+            records.begin(chunk.firstRecord);
+
+            bool read = true;
+            if constexpr (std::is_same<Records, RecordSolver>::value) {
+                if (packedRecordSize != 0) {
+                    // Packed records are fixed-size: no line splitting, no whitespace to strip.
+                    const char* const base = mappedInput->data();
+                    for (uint64_t position = range.begin; position < range.end; position += packedRecordSize) {
+                        progress.addProcessed();
+                        records.processPacked(reinterpret_cast<const uint8_t*>(base + position), outputBuffer);
+                        if (outputBuffer.size() >= BATCH_SIZE * recordSize) flushBatch();
+                    }
+                    mappedInput->release(range.begin, range.end);
+                } else {
+                    read = forEachLine(workerId, inputFilename, mappedInput, inputFile, line, range, processRecord);
                 }
-                outputBuffer.clear();
-                resultsInBatch = 0;
+            } else {
+                read = forEachLine(workerId, inputFilename, mappedInput, inputFile, line, range, processRecord);
             }
+            if (!read) errorFlag.store(true, std::memory_order_relaxed);
+
+            // Batches never span chunks: the next chunk's records go to a different place.
+            records.finish(outputBuffer);
+            flushBatch();
+            if (journal != nullptr && !errorFlag.load(std::memory_order_relaxed)) {
+                if (records.deferredCount() == deferredBefore) journal->complete(chunkIndex);
+                else retriedChunks.push_back(chunkIndex);
+            }
+
+            load.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - chunkStart).count();
+            load.chunks++;
+            load.records += chunk.recordCount;
         }
-        if(inputFile.bad()){
-             std::cerr << "Worker " << workerId << " Error: Input file stream error." << std::endl;
-             errorFlag.store(true, std::memory_order_relaxed);
-             break;
+
+        if (!records.hasDeferred() || errorFlag.load(std::memory_order_relaxed)) return;
+
+        // No chunks left to claim: retry the aborted puzzles with the larger budget, each
+        // overwriting its own aborted marker.
+        const auto retryStart = std::chrono::steady_clock::now();
+        const bool retried = records.retryDeferred([&](uint64_t record, const char* data) {
+            if (errorFlag.load(std::memory_order_relaxed)) return false;
+            StatsTimer timer(stats.writeSeconds);
+            if (!output.writeAt(record * recordSize, data, recordSize)) {
+                std::cerr << "Worker " << workerId << " Error: Failed writing retried record " << record << " to output file." << std::endl;
+                errorFlag.store(true, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        });
+        load.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - retryStart).count();
+        if (journal != nullptr && retried) {
+            for (size_t retriedChunk : retriedChunks) journal->complete(retriedChunk);
         }
+    }
 
-        currentLine++;
+    template <unsigned BoxRows, unsigned BoxCols>
+    void solveGridChunks(
+        size_t workerId,
+        const MappedFile& mappedInput,
+        const PositionalOutputFile& output,
+        RunJournal* journal,
+        const std::vector<InputChunk>& chunks,
+        ChunkScheduler& scheduler,
+        size_t domain,
+        const RecordMarkers& markers,
+        const SolveOptions& options,
+        WorkerLoad& load,
+        WorkerStats& stats,
+        WorkerProgress& progress,
+        std::atomic<bool>& errorFlag)
+    {
+        GridRecordSolver<BoxRows, BoxCols> records(markers, options, stats, progress);
+        // The input is always mapped here, so its name is never needed.
+        solveChunks(workerId, std::string(), &mappedInput, 0, output, journal, chunks, scheduler, domain, records,
+                    load, stats, progress, errorFlag);
     }
 
+}
+
+void solverWorker(
+    size_t workerId,
+    const std::string& inputFilename,
+    const MappedFile* mappedInput,
+    size_t packedRecordSize,
+    const PositionalOutputFile& output,
+    RunJournal* journal,
+    const std::vector<InputChunk>& chunks,
+    ChunkScheduler& scheduler,
+    size_t domain,
+    const RecordMarkers& markers,
+    const SolveOptions& options,
+    WorkerLoad& load,
+    WorkerStats& stats,
+    WorkerProgress& progress,
+    std::atomic<bool>& errorFlag)
+{
+    RecordSolver records(markers, options, stats, progress);
+    solveChunks(workerId, inputFilename, mappedInput, packedRecordSize, output, journal, chunks, scheduler, domain, records,
+                load, stats, progress, errorFlag);
+}
 
-    if (!outputBuffer.empty()) {
-         tempOutputFile.write(outputBuffer.data(), outputBuffer.size());
-         if (!tempOutputFile) {
-             std::cerr << "Worker " << workerId << " Error: Failed writing final batch to temp file: " << tempOutputFilename << std::endl;
-             errorFlag.store(true, std::memory_order_relaxed);
-         }
+void verifierWorker(
+    size_t workerId,
+    const std::string& inputFilename,
+    const MappedFile* mappedInput,
+    const std::vector<InputChunk>& chunks,
+    ChunkScheduler& scheduler,
+    size_t domain,
+    WorkerLoad& load,
+    WorkerProgress& progress,
+    std::vector<VerifyFailure>& failures,
+    std::atomic<bool>& errorFlag)
+{
+    constexpr size_t LANES = SolutionVerifier::LANES;
+    SolutionVerifier verifier;
+    uint64_t laneRecords[LANES];
+    VerifyResult results[LANES];
+    size_t lanesUsed = 0;
+    uint64_t nextRecord = 0;
+
+    auto checkLanes = [&]() {
+        if (lanesUsed == 0) return;
+        verifier.check(lanesUsed, results);
+        for (size_t lane = 0; lane < lanesUsed; ++lane) {
+            if (results[lane] == VerifyResult::Valid) progress.addSolved();
+            else failures.push_back({laneRecords[lane], results[lane]});
+        }
+        lanesUsed = 0;
+    };
+
+    // Malformed records take no lane; the failures are sorted by record afterwards.
+    auto processRecord = [&](const char* record, size_t len) {
+        progress.addProcessed();
+        char scratch[162];
+        const char* puzzle;
+        const char* solution;
+        if (!splitVerifyRecord(record, len, scratch, puzzle, solution)) {
+            failures.push_back({nextRecord++, VerifyResult::Malformed});
+            return;
+        }
+        laneRecords[lanesUsed] = nextRecord++;
+        verifier.load(lanesUsed++, puzzle, solution);
+        if (lanesUsed == LANES) checkLanes();
+    };
+
+    std::ifstream inputFile;
+    if (mappedInput == nullptr) {
+        inputFile.open(inputFilename, std::ios::binary);
+        if (!inputFile) {
+            std::cerr << "Worker " << workerId << " Error: Cannot open input file: " << inputFilename << std::endl;
+            errorFlag.store(true, std::memory_order_relaxed);
+            return;
+        }
     }
+    std::string line;
 
+    size_t chunkIndex = 0;
+    while (!errorFlag.load(std::memory_order_relaxed) && scheduler.claim(chunkIndex, domain)) {
+        const auto chunkStart = std::chrono::steady_clock::now();
+        const InputChunk& chunk = chunks[chunkIndex];
+        nextRecord = chunk.firstRecord;
+        if (!forEachLine(workerId, inputFilename, mappedInput, inputFile, line, chunk.range, processRecord)) {
+            errorFlag.store(true, std::memory_order_relaxed);
+        }
+        checkLanes();
 
+        load.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - chunkStart).count();
+        load.chunks++;
+        load.records += chunk.recordCount;
+    }
+}
+
+void gridSolverWorker(
+    unsigned gridSize,
+    size_t workerId,
+    const MappedFile& mappedInput,
+    const PositionalOutputFile& output,
+    RunJournal* journal,
+    const std::vector<InputChunk>& chunks,
+    ChunkScheduler& scheduler,
+    size_t domain,
+    const RecordMarkers& markers,
+    const SolveOptions& options,
+    WorkerLoad& load,
+    WorkerStats& stats,
+    WorkerProgress& progress,
+    std::atomic<bool>& errorFlag)
+{
+    switch (gridSize) {
+        case 4:
+            solveGridChunks<2, 2>(workerId, mappedInput, output, journal, chunks, scheduler, domain, markers, options,
+                                  load, stats, progress, errorFlag);
+            break;
+        case 16:
+            solveGridChunks<4, 4>(workerId, mappedInput, output, journal, chunks, scheduler, domain, markers, options,
+                                  load, stats, progress, errorFlag);
+            break;
+        case 25:
+            solveGridChunks<5, 5>(workerId, mappedInput, output, journal, chunks, scheduler, domain, markers, options,
+                                  load, stats, progress, errorFlag);
+            break;
+        default:
+            solveGridChunks<3, 3>(workerId, mappedInput, output, journal, chunks, scheduler, domain, markers, options,
+                                  load, stats, progress, errorFlag);
+            break;
+    }
 }
 
-}
\ No newline at end of file
+}